@@ -32,6 +32,7 @@
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_Utility.H>
 #include <AMReX_DistributionMapping.H>
+#include <AMReX_LayoutData.H>
 #include <AMReX_FabSet.H>
 #include <AMReX_StateData.H>
 #include <AMReX_PlotFileUtil.H>
@@ -70,6 +71,10 @@ Vector<BoxArray>        Amr::regrid_ba;
 namespace
 {
     const std::string CheckPointVersion("CheckPointVersion_1.0");
+    //
+    // Like 1.0, except the level BoxArrays are in BoxArray::writeBinary form.
+    //
+    const std::string CheckPointVersionBinaryBA("CheckPointVersion_1.1");
 
     bool initialized = false;
 }
@@ -1379,6 +1384,14 @@ Amr::restart (const std::string& filename)
       }
     }
 
+    //
+    // Metadata for FillBoundary and ParallelCopy.  It is only used by
+    // FabArrays whose BoxArray and DistributionMapping have not changed.
+    //
+    if (FabArrayBase::checkpoint_comm_metadata) {
+        FabArrayBase::readCommMetaData(filename + "/CommMetaData");
+    }
+
     //
     // Open the checkpoint header file for reading.
     //
@@ -1401,7 +1414,7 @@ Amr::restart (const std::string& filename)
 
     std::getline(is,first_line);
 
-    if (first_line == CheckPointVersion)
+    if (first_line == CheckPointVersion || first_line == CheckPointVersionBinaryBA)
     {
         new_checkpoint_format = true;
         is >> spdim;
@@ -1705,7 +1718,8 @@ Amr::checkPoint ()
 
         old_prec = HeaderFile.precision(17);
 
-        HeaderFile << CheckPointVersion << '\n'
+        HeaderFile << (BoxArray::BinaryCheckpoint() ? CheckPointVersionBinaryBA
+                                                    : CheckPointVersion) << '\n'
                    << BL_SPACEDIM       << '\n'
                    << cumtime           << '\n'
                    << max_level         << '\n'
@@ -1733,6 +1747,10 @@ Amr::checkPoint ()
         amr_level[i]->checkPoint(ckfileTemp, HeaderFile);
     }
 
+    if (FabArrayBase::checkpoint_comm_metadata) {
+        FabArrayBase::writeCommMetaData(ckfileTemp + "/CommMetaData", checkpoint_nfiles);
+    }
+
     if (ParallelDescriptor::IOProcessor()) {
 	const Vector<std::string> &FAHeaderNames = StateData::FabArrayHeaderNames();
 	if(FAHeaderNames.size() > 0) {
@@ -2465,6 +2483,18 @@ Amr::regrid (int  lbase,
         }
     }
 
+    //
+    // Keep the communication metadata caches within fabarray.cache_max_bytes,
+    // and free the communicators of the neighbor plans they dropped.
+    //
+    FabArrayBase::trimCaches();
+    FabArrayBase::freeNeighborComms();
+    //
+    // And give the memory of the old grids back to the system if The_Arena()
+    // kept it.
+    //
+    The_Arena()->release();
+
     //
     // Report creation of new grids.
     //
@@ -2522,7 +2552,16 @@ Amr::makeLoadBalanceDistributionMap (int lev, Real time, const BoxArray& ba) con
 
     const int work_est_type = amr_level[0]->WorkEstType();
 
-    if (work_est_type < 0) {
+    const LayoutData<Real>* cost = amr_level[lev] ? amr_level[lev]->boxCosts() : nullptr;
+
+    if (cost && cost->boxArray() == ba)
+    {
+        Real navg = static_cast<Real>(ba.size()) / static_cast<Real>(ParallelDescriptor::NProcs());
+        int nmax = std::max(std::round(loadbalance_max_fac*navg), std::ceil(navg));
+
+        newdm = DistributionMapping::makeKnapSack(*cost, nmax);
+    }
+    else if (work_est_type < 0) {
         amrex::Print() << "\nAMREX WARNING: work estimates type does not exist!\n\n";
         newdm.define(ba);
     }
@@ -429,7 +429,11 @@ AmrLevel::checkPoint (const std::string& dir,
     if (ParallelDescriptor::IOProcessor())
     {
         os << level << '\n' << geom  << '\n';
-        grids.writeOn(os);
+        if (BoxArray::BinaryCheckpoint()) {
+            grids.writeBinary(os);
+        } else {
+            grids.writeOn(os);
+        }
         os << ndesc << '\n';
     }
     //
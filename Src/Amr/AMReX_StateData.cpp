@@ -724,7 +724,11 @@ StateData::checkPoint (const std::string& name,
 
         os << domain << '\n';
 
-        grids.writeOn(os);
+        if (BoxArray::BinaryCheckpoint()) {
+            grids.writeBinary(os);
+        } else {
+            grids.writeOn(os);
+        }
 
         os << old_time.start << '\n'
            << old_time.stop  << '\n'
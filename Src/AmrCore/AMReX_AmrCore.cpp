@@ -107,6 +107,9 @@ AmrCore::regrid (int lbase, Real time, bool)
     }
 
     finest_level = new_finest;
+
+    FabArrayBase::trimCaches();
+    FabArrayBase::freeNeighborComms();
 }
 
 
@@ -39,13 +39,13 @@ namespace amrex
 	return crse_box.contains(fine_box_coarsened);
     }
 
-    void FillPatchSingleLevel (MultiFab& mf, Real time, 
-			       const Vector<MultiFab*>& smf, const Vector<Real>& stime,
-			       int scomp, int dcomp, int ncomp,
-			       const Geometry& geom, PhysBCFunctBase& physbcf)
+namespace
+{
+    // FillPatchSingleLevel without the physical boundary conditions.
+    void FillPatchSingleLevel_nophysbc (MultiFab& mf, Real time,
+                                        const Vector<MultiFab*>& smf, const Vector<Real>& stime,
+                                        int scomp, int dcomp, int ncomp, const Geometry& geom)
     {
-	BL_PROFILE("FillPatchSingleLevel");
-
 	BL_ASSERT(scomp+ncomp <= smf[0]->nComp());
 	BL_ASSERT(dcomp+ncomp <= mf.nComp());
 	BL_ASSERT(smf.size() == stime.size());
@@ -110,6 +110,17 @@ namespace amrex
 	else {
 	    amrex::Abort("FillPatchSingleLevel: high-order interpolation in time not implemented yet");
 	}
+    }
+}
+
+    void FillPatchSingleLevel (MultiFab& mf, Real time, 
+			       const Vector<MultiFab*>& smf, const Vector<Real>& stime,
+			       int scomp, int dcomp, int ncomp,
+			       const Geometry& geom, PhysBCFunctBase& physbcf)
+    {
+	BL_PROFILE("FillPatchSingleLevel");
+
+	FillPatchSingleLevel_nophysbc(mf, time, smf, stime, scomp, dcomp, ncomp, geom);
 
 	physbcf.FillBoundary(mf, dcomp, ncomp, time);
     }
@@ -142,6 +153,15 @@ namespace amrex
 	BL_PROFILE("FillPatchTwoLevels");
 
 	int ngrow = mf.nGrow();
+
+	//
+	// With a single coarse time level, the coarse data are copied with
+	// ParallelCopy_nowait so that the messages overlap with filling mf
+	// from the fine level.  This is not done for periodic domains, because
+	// there the interpolation also writes ghost cells outside the domain
+	// that must be overwritten by the periodic fine copy afterwards.
+	//
+	bool fine_filled = false;
 	    
 	if (ngrow > 0 || mf.getBDKey() != fmf[0]->getBDKey()) 
 	{
@@ -165,7 +185,19 @@ namespace amrex
 		MultiFab mf_crse_patch(fpc.ba_crse_patch, fpc.dm_crse_patch, ncomp, 0, MFInfo(),
                                        *fpc.fact_crse_patch);
 		
-		FillPatchSingleLevel(mf_crse_patch, time, cmf, ct, scomp, 0, ncomp, cgeom, cbc);
+		if (cmf.size() == 1 && !fgeom.isAnyPeriodic())
+		{
+		    BL_ASSERT(scomp+ncomp <= cmf[0]->nComp());
+		    mf_crse_patch.ParallelCopy_nowait(*cmf[0], scomp, 0, ncomp, cgeom.periodicity());
+		    FillPatchSingleLevel_nophysbc(mf, time, fmf, ft, scomp, dcomp, ncomp, fgeom);
+		    mf_crse_patch.ParallelCopy_finish();
+		    cbc.FillBoundary(mf_crse_patch, 0, ncomp, time);
+		    fine_filled = true;
+		}
+		else
+		{
+		    FillPatchSingleLevel(mf_crse_patch, time, cmf, ct, scomp, 0, ncomp, cgeom, cbc);
+		}
 		
 		int idummy1=0, idummy2=0;
 		bool cc = fpc.ba_crse_patch.ixType().cellCentered();
@@ -197,7 +229,11 @@ namespace amrex
 	    }
 	}
 
-	FillPatchSingleLevel(mf, time, fmf, ft, scomp, dcomp, ncomp, fgeom, fbc);
+	if (fine_filled) {
+	    fbc.FillBoundary(mf, dcomp, ncomp, time);
+	} else {
+	    FillPatchSingleLevel(mf, time, fmf, ft, scomp, dcomp, ncomp, fgeom, fbc);
+	}
     }
 
     void InterpFromCoarseLevel (MultiFab& mf, Real time, const MultiFab& cmf, 
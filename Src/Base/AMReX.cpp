@@ -20,6 +20,7 @@
 #include <AMReX_MultiFab.H>
 #include <AMReX_iMultiFab.H>
 #include <AMReX_VisMF.H>
+#include <AMReX_ScratchPad.H>
 #endif
 
 #ifdef BL_LAZY
@@ -393,12 +394,15 @@ amrex::Initialize (int& argc, char**& argv, bool build_parm_parse,
 
     amrex_mempool_init();
 
+    InitializeFabArena();
+
     // For thread safety, we should do these initializations here.
     BoxArray::Initialize();
     DistributionMapping::Initialize();
     FArrayBox::Initialize();
     IArrayBox::Initialize();
     FabArrayBase::Initialize();
+    ScratchPad::Initialize();
     MultiFab::Initialize();
     iMultiFab::Initialize();
     VisMF::Initialize();
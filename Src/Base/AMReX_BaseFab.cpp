@@ -1,11 +1,16 @@
 
 
+#include <atomic>
 #include <cstring>
 #include <cstdlib>
+#include <string>
 
 #include <AMReX_BaseFab.H>
 #include <AMReX_BArena.H>
 #include <AMReX_CArena.H>
+#include <AMReX_TArena.H>
+#include <AMReX_HArena.H>
+#include <AMReX_ParmParse.H>
 
 #if !defined(BL_NO_FORT)
 #include <AMReX_BaseFab_f.H>
@@ -27,6 +32,25 @@ int BF_init::m_cnt = 0;
 namespace
 {
     Arena* the_arena = 0;
+    //
+    // The fab.arena name of the_arena, and whether The_Arena() has handed
+    // it out yet, after which it can't be replaced.
+    //
+    std::string the_arena_name;
+    std::atomic<bool> the_arena_used(false);
+
+    //
+    // If bx spans fabbox in all but the last direction, the cells of bx
+    // are contiguous in memory for each component.
+    //
+    bool
+    contiguousIn (const Box& bx, const Box& fabbox)
+    {
+        for (int d = 0; d < BL_SPACEDIM-1; ++d) {
+            if (bx.length(d) != fabbox.length(d)) return false;
+        }
+        return true;
+    }
 }
 
 BF_init::BF_init ()
@@ -35,10 +59,15 @@ BF_init::BF_init ()
     {
         BL_ASSERT(the_arena == 0);
 
-#if defined(BL_COALESCE_FABS)
+#if defined(BL_THREAD_CACHE_FABS)
+        the_arena = new TArena;
+        the_arena_name = "tarena";
+#elif defined(BL_COALESCE_FABS)
         the_arena = new CArena;
+        the_arena_name = "carena";
 #else
         the_arena = new BArena;
+        the_arena_name = "barena";
 #endif
 
 #ifdef _OPENMP
@@ -67,6 +96,56 @@ BF_init::~BF_init ()
         delete the_arena;
 }
 
+void
+InitializeFabArena ()
+{
+    ParmParse pp("fab");
+
+    std::string name;
+    if (!pp.query("arena", name) || name == the_arena_name)
+        return;
+
+    if (the_arena_used.load(std::memory_order_relaxed))
+    {
+        //
+        // Memory from the old arena, which needn't be FAB data, may still
+        // be live and must go back to it.
+        //
+        amrex::Warning("InitializeFabArena(): The_Arena() already used, ignoring fab.arena");
+        return;
+    }
+
+    Arena* arena = 0;
+
+    if (name == "barena")
+    {
+        arena = new BArena;
+    }
+    else if (name == "carena")
+    {
+        arena = new CArena;
+    }
+    else if (name == "tarena")
+    {
+        arena = new TArena;
+    }
+    else if (name == "harena")
+    {
+        int hugetlb = 1;
+        pp.query("hugetlb", hugetlb);
+        arena = new HArena(0, hugetlb);
+    }
+    else
+    {
+        std::string msg = "InitializeFabArena(): unknown fab.arena = " + name;
+        amrex::Abort(msg.c_str());
+    }
+
+    delete the_arena;
+    the_arena = arena;
+    the_arena_name = name;
+}
+
 long 
 TotalBytesAllocatedInFabs()
 {
@@ -160,6 +239,9 @@ The_Arena ()
 {
     BL_ASSERT(the_arena != 0);
 
+    if (!the_arena_used.load(std::memory_order_relaxed))
+        the_arena_used.store(true, std::memory_order_relaxed);
+
     return the_arena;
 }
 
@@ -196,7 +278,17 @@ BaseFab<Real>::copyToMem (const Box& srcbox,
     BL_ASSERT(box().contains(srcbox));
     BL_ASSERT(srccomp >= 0 && srccomp+numcomp <= nComp());
 
-    if (srcbox.ok())
+    if (srcbox.ok() && contiguousIn(srcbox, domain))
+    {
+        const long npts = srcbox.numPts();
+        const long off  = domain.index(srcbox.smallEnd());
+        Real* p = static_cast<Real*>(dst);
+        for (int n = 0; n < numcomp; ++n, p += npts) {
+            std::memcpy(p, dataPtr(srccomp+n)+off, npts*sizeof(Real));
+        }
+        return sizeof(Real) * npts * numcomp;
+    }
+    else if (srcbox.ok())
     {
 	long nreal =  fort_fab_copytomem(ARLIM_3D(srcbox.loVect()), ARLIM_3D(srcbox.hiVect()),
                                          static_cast<Real*>(dst),
@@ -220,7 +312,17 @@ BaseFab<Real>::copyFromMem (const Box&  dstbox,
     BL_ASSERT(box().contains(dstbox));
     BL_ASSERT(dstcomp >= 0 && dstcomp+numcomp <= nComp());
 
-    if (dstbox.ok()) 
+    if (dstbox.ok() && contiguousIn(dstbox, domain))
+    {
+        const long npts = dstbox.numPts();
+        const long off  = domain.index(dstbox.smallEnd());
+        const Real* p = static_cast<const Real*>(src);
+        for (int n = 0; n < numcomp; ++n, p += npts) {
+            std::memcpy(dataPtr(dstcomp+n)+off, p, npts*sizeof(Real));
+        }
+        return sizeof(Real) * npts * numcomp;
+    }
+    else if (dstbox.ok()) 
     {
 	long nreal = fort_fab_copyfrommem(ARLIM_3D(dstbox.loVect()), ARLIM_3D(dstbox.hiVect()),
                                           BL_TO_FORTRAN_N_3D(*this,dstcomp), &numcomp,
@@ -590,7 +692,17 @@ BaseFab<int>::copyToMem (const Box& srcbox,
     BL_ASSERT(box().contains(srcbox));
     BL_ASSERT(srccomp >= 0 && srccomp+numcomp <= nComp());
 
-    if (srcbox.ok())
+    if (srcbox.ok() && contiguousIn(srcbox, domain))
+    {
+        const long npts = srcbox.numPts();
+        const long off  = domain.index(srcbox.smallEnd());
+        int* p = static_cast<int*>(dst);
+        for (int n = 0; n < numcomp; ++n, p += npts) {
+            std::memcpy(p, dataPtr(srccomp+n)+off, npts*sizeof(int));
+        }
+        return sizeof(int) * npts * numcomp;
+    }
+    else if (srcbox.ok())
     {
 	long nints =  fort_ifab_copytomem(ARLIM_3D(srcbox.loVect()), ARLIM_3D(srcbox.hiVect()),
                                           static_cast<int*>(dst),
@@ -614,7 +726,17 @@ BaseFab<int>::copyFromMem (const Box&  dstbox,
     BL_ASSERT(box().contains(dstbox));
     BL_ASSERT(dstcomp >= 0 && dstcomp+numcomp <= nComp());
 
-    if (dstbox.ok()) 
+    if (dstbox.ok() && contiguousIn(dstbox, domain))
+    {
+        const long npts = dstbox.numPts();
+        const long off  = domain.index(dstbox.smallEnd());
+        const int* p = static_cast<const int*>(src);
+        for (int n = 0; n < numcomp; ++n, p += npts) {
+            std::memcpy(dataPtr(dstcomp+n)+off, p, npts*sizeof(int));
+        }
+        return sizeof(int) * npts * numcomp;
+    }
+    else if (dstbox.ok()) 
     {
 	long nints = fort_ifab_copyfrommem(ARLIM_3D(dstbox.loVect()), ARLIM_3D(dstbox.hiVect()),
                                            BL_TO_FORTRAN_N_3D(*this,dstcomp), &numcomp,
@@ -5,11 +5,18 @@
 #include <AMReX_Utility.H>
 #include <AMReX_MFIter.H>
 #include <AMReX_BaseFab.H>
+#include <AMReX_ParmParse.H>
+
+#include <numeric>
 
 #ifdef BL_MEM_PROFILING
 #include <AMReX_MemProfiler.H>
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace amrex {
 
 #ifdef BL_MEM_PROFILING
@@ -22,10 +29,127 @@ long BARef::total_hash_bytes_hwm = 0L;
 #endif
 
 bool    BARef::initialized = false;
+int     BARef::bvh_threshold = 8;
+long    BARef::implicit_threshold = 4096;
+int     BARef::binary_checkpoint = 0;
 bool BoxArray::initialized = false;
 
 namespace {
     const int bl_ignore_max = 100000;
+
+    //
+    // The compact binary form of a list of boxes: the box count, the
+    // index type, then for each box its small end as a difference from
+    // the previous box's small end and its big end as a difference from
+    // its own small end, all as zigzag varints.  Boxes of a BoxArray are
+    // usually close to their predecessor and of similar size, so most
+    // components take a single byte.
+    //
+    void encodeBoxes (const BoxArray& ba, Vector<char>& buf)
+    {
+        const int N = ba.size();
+        buf.reserve(buf.size() + 16 + 2*BL_SPACEDIM*N);
+        amrex::PutVarint(buf, N);
+        const IntVect typ = ba.ixType().ixType();
+        for (int d = 0; d < BL_SPACEDIM; ++d)
+            amrex::PutVarint(buf, typ[d]);
+        IntVect prev = IntVect::TheZeroVector();
+        for (int i = 0; i < N; ++i)
+        {
+            const Box& bx = ba[i];
+            const IntVect& lo = bx.smallEnd();
+            const IntVect& hi = bx.bigEnd();
+            for (int d = 0; d < BL_SPACEDIM; ++d)
+                amrex::PutVarint(buf, static_cast<long>(lo[d]) - prev[d]);
+            for (int d = 0; d < BL_SPACEDIM; ++d)
+                amrex::PutVarint(buf, static_cast<long>(hi[d]) - lo[d]);
+            prev = lo;
+        }
+    }
+
+    //
+    // Decodes what encodeBoxes wrote into [p,end); the boxes come back
+    // with their index type.  Truncated or corrupt input is an error.
+    //
+    const char* decodeBoxes (const char* p, const char* end, Vector<Box>& boxes)
+    {
+        const long N = amrex::GetVarint(p, end);
+        //
+        // Each box takes at least 2*BL_SPACEDIM bytes.
+        //
+        if (N < 0 || N > (end - p) / (2*BL_SPACEDIM))
+            amrex::Error("BoxArray: corrupt binary box count");
+        IntVect typ;
+        for (int d = 0; d < BL_SPACEDIM; ++d)
+        {
+            typ[d] = amrex::GetVarint(p, end);
+            if (typ[d] != 0 && typ[d] != 1)
+                amrex::Error("BoxArray: corrupt binary index type");
+        }
+        const IndexType ixtyp(typ);
+        boxes.resize(N);
+        IntVect lo = IntVect::TheZeroVector(), hi;
+        for (long i = 0; i < N; ++i)
+        {
+            for (int d = 0; d < BL_SPACEDIM; ++d)
+                lo[d] += amrex::GetVarint(p, end);
+            for (int d = 0; d < BL_SPACEDIM; ++d)
+                hi[d] = lo[d] + amrex::GetVarint(p, end);
+            boxes[i] = Box(lo, hi, ixtyp);
+        }
+        return p;
+    }
+
+    //
+    // Checkpoint headers are read back as C strings, so writeBinary stores
+    // the encoded bytes, which contain NULs, as base64 text.
+    //
+    const char base64_chars[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    void toBase64 (const Vector<char>& in, std::string& out)
+    {
+        const long n = in.size();
+        out.clear();
+        out.reserve(4*((n+2)/3));
+        for (long i = 0; i < n; i += 3)
+        {
+            unsigned long v = static_cast<unsigned char>(in[i]) << 16;
+            if (i+1 < n) v |= static_cast<unsigned char>(in[i+1]) << 8;
+            if (i+2 < n) v |= static_cast<unsigned char>(in[i+2]);
+            out += base64_chars[(v >> 18) & 0x3f];
+            out += base64_chars[(v >> 12) & 0x3f];
+            out += (i+1 < n) ? base64_chars[(v >> 6) & 0x3f] : '=';
+            out += (i+2 < n) ? base64_chars[v & 0x3f] : '=';
+        }
+    }
+
+    int fromBase64Char (char c)
+    {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+') return 62;
+        if (c == '/') return 63;
+        amrex::Error("BoxArray: corrupt base64 data");
+        return 0;
+    }
+
+    // Decodes nbytes bytes from the 4*ceil(nbytes/3) characters of in.
+    void fromBase64 (const std::string& in, long nbytes, Vector<char>& out)
+    {
+        BL_ASSERT(long(in.size()) == 4*((nbytes+2)/3));
+        out.resize(nbytes);
+        for (long i = 0, j = 0; j < nbytes; i += 4, j += 3)
+        {
+            unsigned long v = (fromBase64Char(in[i]) << 18) | (fromBase64Char(in[i+1]) << 12);
+            if (j+1 < nbytes) v |= fromBase64Char(in[i+2]) << 6;
+            if (j+2 < nbytes) v |= fromBase64Char(in[i+3]);
+            out[j] = static_cast<char>((v >> 16) & 0xff);
+            if (j+1 < nbytes) out[j+1] = static_cast<char>((v >> 8) & 0xff);
+            if (j+2 < nbytes) out[j+2] = static_cast<char>(v & 0xff);
+        }
+    }
 }
 
 BARef::BARef () 
@@ -70,8 +194,16 @@ BARef::BARef (std::istream& is)
 }
 
 BARef::BARef (const BARef& rhs) 
-    : m_abox(rhs.m_abox) // don't copy hash
-{
+    : m_abox(rhs.m_abox), // don't copy hash
+      m_implicit(rhs.m_implicit),
+      m_nimplicit(rhs.m_nimplicit),
+      m_except(rhs.m_except)
+{
+    for (int d = 0; d < BL_SPACEDIM; ++d) {
+        m_ilo[d] = rhs.m_ilo[d];
+        m_ihi[d] = rhs.m_ihi[d];
+        m_istride[d] = rhs.m_istride[d];
+    }
 #ifdef BL_MEM_PROFILING
     updateMemoryUsage_box(1);
 #endif	    
@@ -82,6 +214,7 @@ BARef::~BARef ()
 #ifdef BL_MEM_PROFILING
     updateMemoryUsage_box(-1);
     updateMemoryUsage_hash(-1);
+    updateMemoryUsage_bvh(-1);
 #endif	    
 }
 
@@ -92,12 +225,40 @@ BARef::define (std::istream& is)
     // TODO -- completely remove the fiction of a hash value.
     //
     BL_ASSERT(m_abox.size() == 0);
-    int           maxbox;
-    unsigned long tmphash;
-    is.ignore(bl_ignore_max, '(') >> maxbox >> tmphash;
-    resize(maxbox);
-    for (Vector<Box>::iterator it = m_abox.begin(), End = m_abox.end(); it != End; ++it)
-        is >> *it;
+    is.ignore(bl_ignore_max, '(') >> std::ws;
+    if (is.peek() == 'B')
+    {
+        //
+        // The compact form written by BoxArray::writeBinary.
+        //
+        long nbytes = -1;
+        is.get();
+        is >> nbytes >> std::ws;
+        if (is.fail() || nbytes < 0)
+            amrex::Error("BoxArray::define(istream&) failed");
+        std::string text(4*((nbytes+2)/3), ' ');
+        is.read(&text[0], text.size());
+        if (is.fail())
+            amrex::Error("BoxArray::define(istream&) failed");
+        Vector<char> buf;
+        fromBase64(text, nbytes, buf);
+#ifdef BL_MEM_PROFILING
+        updateMemoryUsage_box(-1);
+#endif
+        decodeBoxes(buf.dataPtr(), buf.dataPtr() + buf.size(), m_abox);
+#ifdef BL_MEM_PROFILING
+        updateMemoryUsage_box(1);
+#endif
+    }
+    else
+    {
+        int           maxbox;
+        unsigned long tmphash;
+        is >> maxbox >> tmphash;
+        resize(maxbox);
+        for (Vector<Box>::iterator it = m_abox.begin(), End = m_abox.end(); it != End; ++it)
+            is >> *it;
+    }
     is.ignore(bl_ignore_max, ')');
     if (is.fail())
         amrex::Error("BoxArray::define(istream&) failed");
@@ -142,13 +303,18 @@ BARef::define (BoxList&& bl) noexcept
 
 void 
 BARef::resize (long n) {
+    BL_ASSERT(!m_implicit);
 #ifdef BL_MEM_PROFILING
     updateMemoryUsage_box(-1);
     updateMemoryUsage_hash(-1);
+    updateMemoryUsage_bvh(-1);
 #endif
     m_abox.resize(n);
     hash.clear();
     has_hashmap = false;
+    bvh.clear();
+    bvh_index.clear();
+    index_kind = -1;
 #ifdef BL_MEM_PROFILING
     updateMemoryUsage_box(1);
 #endif
@@ -158,8 +324,11 @@ BARef::resize (long n) {
 void
 BARef::updateMemoryUsage_box (int s)
 {
-    if (m_abox.size() > 1) {
-	long b = amrex::bytesOf(m_abox);
+    if (size() > 1) {
+	long b = amrex::bytesOf(m_abox) + amrex::bytesOf(m_except);
+	for (int d = 0; d < BL_SPACEDIM; ++d) {
+	    b += amrex::bytesOf(m_ilo[d]) + amrex::bytesOf(m_ihi[d]);
+	}
 	if (s > 0) {
 	    total_box_bytes += b;
 	    total_box_bytes_hwm = std::max(total_box_bytes_hwm, total_box_bytes);
@@ -191,11 +360,374 @@ BARef::updateMemoryUsage_hash (int s)
 }
 #endif
 
+namespace {
+    //
+    // Chops [lo,hi] into pieces of at most chunk cells the same way as
+    // BoxList::maxSize, and returns the pieces from low to high.
+    //
+    void
+    chopInterval (int lo, int hi, int chunk, std::vector<int>& plo, std::vector<int>& phi)
+    {
+        plo.clear();
+        phi.clear();
+
+        const int len = hi - lo + 1;
+        if (len > chunk)
+        {
+            int ratio = 1;
+            int bs    = chunk;
+            int nlen  = len;
+            while ((bs%2 == 0) && (nlen%2 == 0))
+            {
+                ratio *= 2;
+                bs    /= 2;
+                nlen  /= 2;
+            }
+            const int numblk = nlen/bs + (nlen%bs ? 1 : 0);
+            const int sz     = nlen/numblk;
+            const int extra  = nlen%numblk;
+            //
+            // BoxList::maxSize chops from the high end.
+            //
+            for (int k = 0; k < numblk-1; k++)
+            {
+                const int ksize = (k < extra ? sz+1 : sz) * ratio;
+                phi.push_back(hi);
+                plo.push_back(hi - ksize + 1);
+                hi -= ksize;
+            }
+        }
+        phi.push_back(hi);
+        plo.push_back(lo);
+
+        std::reverse(plo.begin(), plo.end());
+        std::reverse(phi.begin(), phi.end());
+    }
+
+    //
+    // Applies f to every box of the implicit storage.  f must treat each
+    // direction separately (e.g. refine, coarsen, grow or shift), so that
+    // the intervals stay sorted.
+    //
+    template <class F>
+    void
+    transformImplicit (BARef& ref, F&& f)
+    {
+        BL_ASSERT(ref.m_implicit);
+
+        size_t nmax = 0;
+        for (int d = 0; d < BL_SPACEDIM; ++d) {
+            nmax = std::max(nmax, ref.m_ilo[d].size());
+        }
+
+        for (size_t s = 0; s < nmax; ++s)
+        {
+            IntVect lo, hi;
+            for (int d = 0; d < BL_SPACEDIM; ++d) {
+                const size_t sd = std::min(s, ref.m_ilo[d].size()-1);
+                lo[d] = ref.m_ilo[d][sd];
+                hi[d] = ref.m_ihi[d][sd];
+            }
+            const Box& bx = f(Box(lo,hi));
+            for (int d = 0; d < BL_SPACEDIM; ++d) {
+                if (s < ref.m_ilo[d].size()) {
+                    ref.m_ilo[d][s] = bx.smallEnd(d);
+                    ref.m_ihi[d][s] = bx.bigEnd(d);
+                }
+            }
+        }
+
+        for (auto& kv : ref.m_except) {
+            kv.second = f(kv.second);
+        }
+    }
+
+    //
+    // Calls f(i) for every box i in the implicit storage that intersects
+    // bx, until f returns true.
+    //
+    template <class F>
+    void
+    queryImplicit (const BARef& ref, const Box& bx, F&& f)
+    {
+        IntVect slo, shi;
+        bool found = true;
+        for (int d = 0; d < BL_SPACEDIM; ++d)
+        {
+            //
+            // The intervals are sorted, so the ones that intersect bx
+            // are next to each other.
+            //
+            const std::vector<int>& lo = ref.m_ilo[d];
+            const std::vector<int>& hi = ref.m_ihi[d];
+            slo[d] = std::lower_bound(hi.begin(), hi.end(), bx.smallEnd(d)) - hi.begin();
+            shi[d] = std::upper_bound(lo.begin(), lo.end(), bx.bigEnd(d)) - lo.begin() - 1;
+            found = found && slo[d] <= shi[d];
+        }
+
+        if (found)
+        {
+            const Box sbx(slo,shi);
+            for (IntVect s = sbx.smallEnd(), End = sbx.bigEnd(); s <= End; sbx.next(s))
+            {
+                const int i = ref.implicitIndex(s);
+                if (!ref.m_except.empty() && ref.m_except.count(i)) continue;
+                if (f(i)) return;
+            }
+        }
+
+        for (const auto& kv : ref.m_except) {
+            if (kv.second.intersects(bx) && f(kv.first)) return;
+        }
+    }
+
+    //
+    // Adds the BVH node of the boxes index[first] ... index[last-1] and the
+    // nodes below it.  The boxes are split at the median of their centers
+    // along the longest side of their bounding box.
+    //
+    int
+    buildBVHNode (const Vector<Box>& boxes, std::vector<int>& index,
+                  std::vector<BARef::BVHNode>& nodes, int first, int last)
+    {
+        const int leaf_size = 4;
+
+        const int inode = nodes.size();
+        Box bx = boxes[index[first]];
+        for (int k = first+1; k < last; ++k) {
+            bx.minBox(boxes[index[k]]);
+        }
+        nodes.push_back(BARef::BVHNode{bx, first, last, -1});
+
+        if (last - first > leaf_size)
+        {
+            int dir;
+            bx.longside(dir);
+            const int mid = (first+last)/2;
+            std::nth_element(index.begin()+first, index.begin()+mid, index.begin()+last,
+                             [&] (int a, int b) {
+                                 const int ca = boxes[a].smallEnd(dir) + boxes[a].bigEnd(dir);
+                                 const int cb = boxes[b].smallEnd(dir) + boxes[b].bigEnd(dir);
+                                 return ca < cb || (ca == cb && a < b);
+                             });
+            buildBVHNode(boxes, index, nodes, first, mid);
+            const int r = buildBVHNode(boxes, index, nodes, mid, last);
+            nodes[inode].right = r;
+        }
+
+        return inode;
+    }
+
+    //
+    // Calls f(i) for every box i in the BVH that intersects bx, until f
+    // returns true.
+    //
+    template <class F>
+    void
+    queryBVH (const BARef& ref, const Box& bx, F&& f)
+    {
+        if (ref.bvh.empty()) return;
+
+        int stack[64];
+        int n = 0;
+        stack[n++] = 0;
+        while (n > 0)
+        {
+            const BARef::BVHNode& node = ref.bvh[stack[--n]];
+            if (!node.bx.intersects(bx)) continue;
+
+            if (node.right < 0)
+            {
+                for (int k = node.first; k < node.last; ++k) {
+                    const int i = ref.bvh_index[k];
+                    if (ref.m_abox[i].intersects(bx) && f(i)) return;
+                }
+            }
+            else
+            {
+                stack[n++] = node.right;
+                stack[n++] = &node - ref.bvh.data() + 1;  // the left child is visited first
+            }
+        }
+    }
+
+    template <class F>
+    void
+    queryIndex (const BARef& ref, const Box& bx, F&& f)
+    {
+        if (ref.m_implicit) {
+            queryImplicit(ref, bx, std::forward<F>(f));
+        } else {
+            queryBVH(ref, bx, std::forward<F>(f));
+        }
+    }
+}
+
+void
+BARef::defineImplicit (const Box& bx, const IntVect& block_size)
+{
+    BL_ASSERT(bx.ixType().cellCentered());
+#ifdef BL_MEM_PROFILING
+    updateMemoryUsage_box(-1);
+#endif
+    m_abox.clear();
+    m_except.clear();
+    m_implicit = true;
+    long n = 1;
+    for (int d = 0; d < BL_SPACEDIM; ++d) {
+        chopInterval(bx.smallEnd(d), bx.bigEnd(d), block_size[d], m_ilo[d], m_ihi[d]);
+        n *= m_ilo[d].size();
+        m_istride[d] = n;
+    }
+    m_nimplicit = n;
+#ifdef BL_MEM_PROFILING
+    updateMemoryUsage_box(1);
+#endif
+}
+
+//
+// BoxList::maxSize chops direction 0 first.  The low piece stays in place
+// and the others, from high to low, go to the end of the list.  Then
+// direction 1 is chopped the same way for each of these boxes, and so on.
+// So after direction d, the first m_istride[d-1] boxes are the low pieces
+// in direction d, and box m_istride[d-1] + j*(n-1) + p-1 is the p-th
+// piece from the top of box j.
+//
+Box
+BARef::getImplicitBox (int i) const
+{
+    if (!m_except.empty()) {
+        auto it = m_except.find(i);
+        if (it != m_except.end()) return it->second;
+    }
+
+    IntVect lo, hi;
+    long j = i;
+    for (int d = BL_SPACEDIM-1; d >= 0; --d)
+    {
+        const long n = m_ilo[d].size();
+        const long m = (d > 0) ? m_istride[d-1] : 1;
+        long s = 0;
+        if (j >= m) {
+            j -= m;
+            s = n - 1 - j % (n-1);
+            j /= (n-1);
+        }
+        lo[d] = m_ilo[d][s];
+        hi[d] = m_ihi[d][s];
+    }
+    return Box(lo,hi);
+}
+
+long
+BARef::implicitIndex (const IntVect& s) const
+{
+    long j = 0;
+    for (int d = 0; d < BL_SPACEDIM; ++d)
+    {
+        const long n = m_ilo[d].size();
+        const long p = (s[d] == 0) ? 0 : n - s[d];
+        if (d == 0) {
+            j = p;
+        } else if (p > 0) {
+            j = m_istride[d-1] + j*(n-1) + p-1;
+        }
+    }
+    return j;
+}
+
+void
+BARef::materialize ()
+{
+    if (!m_implicit) return;
+
+#ifdef BL_MEM_PROFILING
+    updateMemoryUsage_box(-1);
+#endif
+    const int N = m_nimplicit;
+    Vector<Box> bxs(N);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < N; ++i) {
+        bxs[i] = getImplicitBox(i);
+    }
+
+    m_implicit = false;
+    m_nimplicit = 0;
+    for (int d = 0; d < BL_SPACEDIM; ++d) {
+        m_ilo[d].clear();
+        m_ihi[d].clear();
+    }
+    m_except.clear();
+    m_abox = std::move(bxs);
+#ifdef BL_MEM_PROFILING
+    updateMemoryUsage_box(1);
+#endif
+}
+
+bool
+BARef::sameBoxes (const BARef& rhs) const
+{
+    if (!m_implicit && !rhs.m_implicit) {
+        return m_abox == rhs.m_abox;
+    }
+
+    if (m_implicit && rhs.m_implicit && m_nimplicit == rhs.m_nimplicit)
+    {
+        bool r = m_except == rhs.m_except;
+        for (int d = 0; d < BL_SPACEDIM; ++d) {
+            r = r && m_ilo[d] == rhs.m_ilo[d] && m_ihi[d] == rhs.m_ihi[d];
+        }
+        if (r) return true;
+    }
+
+    const long N = size();
+    if (N != rhs.size()) return false;
+    for (long i = 0; i < N; ++i) {
+        if (getBox(i) != rhs.getBox(i)) return false;
+    }
+    return true;
+}
+
+void
+BARef::buildBVH () const
+{
+    const int N = m_abox.size();
+    bvh_index.resize(N);
+    std::iota(bvh_index.begin(), bvh_index.end(), 0);
+    bvh.clear();
+    bvh.reserve(N/2+1);
+    if (N > 0) {
+        buildBVHNode(m_abox, bvh_index, bvh, 0, N);
+    }
+}
+
+#ifdef BL_MEM_PROFILING
+void
+BARef::updateMemoryUsage_bvh (int s)
+{
+    if (bvh.size() > 0) {
+	long b = amrex::bytesOf(bvh) + amrex::bytesOf(bvh_index);
+	if (s > 0) {
+	    total_hash_bytes += b;
+	    total_hash_bytes_hwm = std::max(total_hash_bytes_hwm, total_hash_bytes);
+	} else {
+	    total_hash_bytes -= b;
+	}
+    }
+}
+#endif
+
 void
 BARef::Initialize ()
 {
     if (!initialized) {
 	initialized = true;
+        ParmParse pp("boxarray");
+        pp.query("bvh_threshold", bvh_threshold);
+        pp.query("implicit_threshold", implicit_threshold);
+        pp.query("binary_checkpoint", binary_checkpoint);
 #ifdef BL_MEM_PROFILING
 	MemProfiler::add("BoxArray", std::function<MemProfiler::MemInfo()>
 			 ([] () -> MemProfiler::MemInfo {
@@ -373,25 +905,26 @@ void
 BoxArray::resize (long len)
 {
     uniqify();
+    m_ref->materialize();
     m_ref->resize(len);
 }
 
 long
 BoxArray::size () const
 {
-    return m_ref->m_abox.size();
+    return m_ref->size();
 }
 
 long
 BoxArray::capacity () const
 {
-    return m_ref->m_abox.capacity();
+    return m_ref->m_implicit ? m_ref->size() : m_ref->m_abox.capacity();
 }
 
 bool
 BoxArray::empty () const
 {
-    return m_ref->m_abox.empty();
+    return m_ref->size() == 0;
 }
 
 long
@@ -456,18 +989,41 @@ BoxArray::writeOn (std::ostream& os) const
     return os;
 }
 
+std::ostream&
+BoxArray::writeBinary (std::ostream& os) const
+{
+    Vector<char> buf;
+    encodeBoxes(*this, buf);
+
+    std::string text;
+    toBase64(buf, text);
+
+    os << "(B " << buf.size() << '\n' << text << ')';
+
+    if (os.fail())
+        amrex::Error("BoxArray::writeBinary(ostream&) failed");
+
+    return os;
+}
+
+bool
+BoxArray::BinaryCheckpoint ()
+{
+    return BARef::binary_checkpoint;
+}
+
 bool
 BoxArray::operator== (const BoxArray& rhs) const
 {
     if (m_simple && rhs.m_simple) {
         return m_typ == rhs.m_typ && m_crse_ratio == rhs.m_crse_ratio &&
-            (m_ref == rhs.m_ref || m_ref->m_abox == rhs.m_ref->m_abox);
+            (m_ref == rhs.m_ref || m_ref->sameBoxes(*rhs.m_ref));
     } else {
         return m_simple == rhs.m_simple
             && m_typ == rhs.m_typ
             && m_crse_ratio == rhs.m_crse_ratio
             && m_transformer->equal(*rhs.m_transformer)
-            && (m_ref == rhs.m_ref || m_ref->m_abox == rhs.m_ref->m_abox);
+            && (m_ref == rhs.m_ref || m_ref->sameBoxes(*rhs.m_ref));
     }
 }
 
@@ -481,7 +1037,7 @@ bool
 BoxArray::CellEqual (const BoxArray& rhs) const
 {
     return m_crse_ratio == rhs.m_crse_ratio
-        && (m_ref == rhs.m_ref || m_ref->m_abox == rhs.m_ref->m_abox);
+        && (m_ref == rhs.m_ref || m_ref->sameBoxes(*rhs.m_ref));
 }
 
 BoxArray&
@@ -493,6 +1049,17 @@ BoxArray::maxSize (int block_size)
 BoxArray&
 BoxArray::maxSize (const IntVect& block_size)
 {
+    if (BARef::implicit_threshold > 0 && size() == 1 && m_simple
+        && m_crse_ratio == IntVect::TheUnitVector() && ixType().cellCentered())
+    {
+        auto p = std::make_shared<BARef>();
+        p->defineImplicit(m_ref->getBox(0), block_size);
+        if (p->size() > BARef::implicit_threshold) {
+            m_ref = p;
+            return *this;
+        }
+    }
+
     BoxList blst(*this);
     blst.maxSize(block_size);
     const int N = blst.size();
@@ -513,6 +1080,11 @@ BoxArray::refine (const IntVect& iv)
 {
     uniqify();
 
+    if (m_ref->m_implicit) {
+        transformImplicit(*m_ref, [&] (Box b) -> Box { return b.refine(iv); });
+        return *this;
+    }
+
     const int N = m_ref->m_abox.size();
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -571,6 +1143,11 @@ BoxArray::growcoarsen (int n, const IntVect& iv)
 {
     uniqify();
 
+    if (m_ref->m_implicit) {
+        transformImplicit(*m_ref, [&] (Box b) -> Box { return b.grow(n).coarsen(iv); });
+        return *this;
+    }
+
     const int N = m_ref->m_abox.size();
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -586,6 +1163,11 @@ BoxArray::grow (int n)
 {
     uniqify();
 
+    if (m_ref->m_implicit) {
+        transformImplicit(*m_ref, [&] (Box b) -> Box { return b.grow(n); });
+        return *this;
+    }
+
     const int N = m_ref->m_abox.size();
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -601,6 +1183,11 @@ BoxArray::grow (const IntVect& iv)
 {
     uniqify();
 
+    if (m_ref->m_implicit) {
+        transformImplicit(*m_ref, [&] (Box b) -> Box { return b.grow(iv); });
+        return *this;
+    }
+
     const int N = m_ref->m_abox.size();
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -617,6 +1204,11 @@ BoxArray::grow (int dir,
 {
     uniqify();
 
+    if (m_ref->m_implicit) {
+        transformImplicit(*m_ref, [&] (Box b) -> Box { return b.grow(dir, n_cell); });
+        return *this;
+    }
+
     const int N = m_ref->m_abox.size();
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -681,6 +1273,7 @@ BoxArray::convert (Box (*fp)(const Box&))
     const int N = size();
     if (N > 0) {
         uniqify();
+        m_ref->materialize();
 
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -698,6 +1291,11 @@ BoxArray::shift (int dir,
 {
     uniqify();
 
+    if (m_ref->m_implicit) {
+        transformImplicit(*m_ref, [&] (Box b) -> Box { return b.shift(dir, nzones); });
+        return *this;
+    }
+
     const int N = m_ref->m_abox.size();
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -713,6 +1311,11 @@ BoxArray::shift (const IntVect& iv)
 {
     uniqify();
 
+    if (m_ref->m_implicit) {
+        transformImplicit(*m_ref, [&] (Box b) -> Box { return b.shift(iv); });
+        return *this;
+    }
+
     const int N = m_ref->m_abox.size();
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -732,16 +1335,32 @@ BoxArray::set (int        i,
         m_typ = ibox.ixType();
         m_transformer->setIxType(m_typ);
     }
-    m_ref->m_abox[i] = amrex::enclosedCells(ibox);
+    if (m_ref->m_implicit)
+    {
+#ifdef BL_MEM_PROFILING
+        m_ref->updateMemoryUsage_box(-1);
+#endif
+        m_ref->m_except[i] = amrex::enclosedCells(ibox);
+#ifdef BL_MEM_PROFILING
+        m_ref->updateMemoryUsage_box(1);
+#endif
+        if (m_ref->m_except.size() > static_cast<std::size_t>(BARef::MaxExcept)) {
+            m_ref->materialize();
+        }
+    }
+    else
+    {
+        m_ref->m_abox[i] = amrex::enclosedCells(ibox);
+    }
 }
 
 Box
 BoxArray::operator[] (int index) const
 {
     if (m_simple) {
-        return amrex::convert(amrex::coarsen(m_ref->m_abox[index],m_crse_ratio), m_typ);
+        return amrex::convert(amrex::coarsen(m_ref->getBox(index),m_crse_ratio), m_typ);
     } else {
-        return (*m_transformer)(m_ref->m_abox[index]); 
+        return (*m_transformer)(m_ref->getBox(index)); 
     }
 }
 
@@ -754,7 +1373,7 @@ BoxArray::operator[] (const MFIter& mfi) const
 Box
 BoxArray::getCellCenteredBox (int index) const
 {
-    return amrex::coarsen(m_ref->m_abox[index],m_crse_ratio);
+    return amrex::coarsen(m_ref->getBox(index),m_crse_ratio);
 }
 
 bool
@@ -878,7 +1497,19 @@ BoxArray::minimalBox () const
     BL_ASSERT(m_simple);
     Box minbox;
     const int N = size();
-    if (N > 0)
+    if (N > 0 && m_ref->m_implicit)
+    {
+        IntVect lo, hi;
+        for (int d = 0; d < BL_SPACEDIM; ++d) {
+            lo[d] = m_ref->m_ilo[d].front();
+            hi[d] = m_ref->m_ihi[d].back();
+        }
+        minbox = Box(lo,hi);
+        for (const auto& kv : m_ref->m_except) {
+            minbox.minBox(kv.second);
+        }
+    }
+    else if (N > 0)
     {
         minbox = m_ref->m_abox[0];
 	for (int i = 1; i < N; ++i) {
@@ -931,10 +1562,32 @@ BoxArray::intersections (const Box&                         bx,
 {
   // This is called too many times BL_PROFILE("BoxArray::intersections()");
 
-    BARef::HashType& BoxHashMap = getHashMap();
-
     isects.resize(0);
 
+    if (m_ref->m_implicit || useBVH())
+    {
+        BL_ASSERT(bx.ixType() == ixType());
+
+        const Box& gbx = amrex::grow(bx,ng);
+        // The region in the index space of the cell-centered boxes in m_ref.
+        Box qbx(gbx.smallEnd() - getDoiHi(), gbx.bigEnd() + getDoiLo());
+        qbx.refine(m_crse_ratio);
+
+        queryIndex(*m_ref, qbx, [&] (int index) -> bool
+        {
+            const Box& isect = bx & amrex::grow((*this)[index],ng);
+            if (isect.ok()) {
+                isects.push_back(std::pair<int,Box>(index,isect));
+                return first_only;
+            }
+            return false;
+        });
+
+        return;
+    }
+
+    BARef::HashType& BoxHashMap = getHashMap();
+
     if (!BoxHashMap.empty())
     {
         BL_ASSERT(bx.ixType() == ixType());
@@ -980,12 +1633,104 @@ BoxArray::intersections (const Box&                         bx,
     }
 }
 
+void
+BoxArray::intersections (const std::vector<Box>& bxs, const std::vector<IntVect>& shifts,
+                         std::vector< std::pair<int,Box> >& isects,
+                         std::vector<int>& offsets, int ng) const
+{
+    const int nshifts = shifts.size();
+    const int nq = bxs.size() * nshifts;
+
+    offsets.resize(nq+1);
+    offsets[0] = 0;
+    isects.resize(0);
+
+    if (nq == 0) return;
+
+#ifdef _OPENMP
+    const int nthreads = omp_in_parallel() ? 1 : std::min(omp_get_max_threads(), nq);
+#else
+    const int nthreads = 1;
+#endif
+
+    if (nthreads == 1)
+    {
+        std::vector< std::pair<int,Box> > tmp;
+        for (int k = 0; k < nq; ++k)
+        {
+            intersections(bxs[k/nshifts]+shifts[k%nshifts], tmp, false, ng);
+            isects.insert(isects.end(), tmp.begin(), tmp.end());
+            offsets[k+1] = isects.size();
+        }
+        return;
+    }
+
+    //
+    // Each thread does a contiguous range of queries, so the results can
+    // be put together in the order of the threads.
+    //
+    std::vector< std::vector< std::pair<int,Box> > > tisects(nthreads);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads)
+#endif
+    {
+#ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+#else
+        const int tid = 0;
+#endif
+        const int klo = (long(tid)*nq)/nthreads;
+        const int khi = (long(tid+1)*nq)/nthreads;
+        std::vector< std::pair<int,Box> >& mine = tisects[tid];
+        std::vector< std::pair<int,Box> > tmp;
+        for (int k = klo; k < khi; ++k)
+        {
+            intersections(bxs[k/nshifts]+shifts[k%nshifts], tmp, false, ng);
+            mine.insert(mine.end(), tmp.begin(), tmp.end());
+            offsets[k+1] = tmp.size();
+        }
+    }
+
+    for (int k = 0; k < nq; ++k) {
+        offsets[k+1] += offsets[k];
+    }
+
+    isects.reserve(offsets[nq]);
+    for (const auto& v : tisects) {
+        isects.insert(isects.end(), v.begin(), v.end());
+    }
+}
+
 BoxList
 BoxArray::complementIn (const Box& bx) const
 {
     BoxList bl(bx);
 
-    if (!empty()) 
+    if (!empty() && (m_ref->m_implicit || useBVH()))
+    {
+	BL_ASSERT(bx.ixType() == ixType());
+
+        Box qbx(bx.smallEnd() - getDoiHi(), bx.bigEnd() + getDoiLo());
+        qbx.refine(m_crse_ratio);
+
+        BoxList newbl(bl.ixType());
+
+        queryIndex(*m_ref, qbx, [&] (int index) -> bool
+        {
+            const Box& isect = bx & (*this)[index];
+            if (isect.ok()) {
+                newbl.clear();
+                for (const Box& b : bl) {
+                    const BoxList& diff = amrex::boxDiff(b, isect);
+                    newbl.join(diff);
+                }
+                std::swap(bl,newbl);
+            }
+            return bl.isEmpty();
+        });
+    }
+    else if (!empty()) 
     {
 	BARef::HashType& BoxHashMap = getHashMap();
 
@@ -1053,6 +1798,15 @@ BoxArray::clear_hash_bin () const
         m_ref->hash.clear();
         m_ref->has_hashmap = false;
     }
+    if (!m_ref->bvh.empty())
+    {
+#ifdef BL_MEM_PROFILING
+	m_ref->updateMemoryUsage_bvh(-1);
+#endif
+        m_ref->bvh.clear();
+        m_ref->bvh_index.clear();
+    }
+    m_ref->index_kind = -1;
 }
 
 //
@@ -1069,56 +1823,54 @@ BoxArray::removeOverlap (bool simplify)
         amrex::Abort("BoxArray::removeOverlap() must have m_crse_ratio == 1");
     }
 
-    uniqify();
-
-    BARef::HashType& BoxHashMap = m_ref->hash;
-
-    const Box EmptyBox;
-
-    std::vector< std::pair<int,Box> > isects;
     //
-    // Note that "size()" can increase in this loop!!!
+    // Each box keeps the part of it that is not covered by the boxes
+    // before it.  The boxes are done independently, so the result does
+    // not depend on the number of threads.
     //
-#ifdef BL_MEM_PROFILING
-    m_ref->updateMemoryUsage_box(-1);
-    m_ref->updateMemoryUsage_hash(-1);
-    long total_hash_bytes_save = m_ref->total_hash_bytes;
+    const int N = size();
+    Vector< Vector<Box> > pieces(N);
+
+#ifdef _OPENMP
+#pragma omp parallel
 #endif
-    for (int i = 0; i < size(); i++)
     {
-        if (m_ref->m_abox[i].ok())
+        std::vector< std::pair<int,Box> > isects;
+        std::vector<int> before;
+        BoxList newbl;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int i = 0; i < N; ++i)
         {
-            intersections(m_ref->m_abox[i],isects);
+            const Box& bx = (*this)[i];
+            if (!bx.ok()) continue;
 
-            for (int j = 0, N = isects.size(); j < N; j++)
-            {
-                if (isects[j].first == i) continue;
-
-                Box& bx = m_ref->m_abox[isects[j].first];
-
-                const BoxList& bl = amrex::boxDiff(bx, isects[j].second);
+            intersections(bx,isects);
 
-                bx = EmptyBox;
+            before.clear();
+            for (const auto& is : isects) {
+                if (is.first < i) before.push_back(is.first);
+            }
+            std::sort(before.begin(), before.end());
 
-                for (const Box& b : bl)
-                {
-                    m_ref->m_abox.push_back(b);
-                    BoxHashMap[amrex::coarsen(b.smallEnd(),m_ref->crsn)].push_back(size()-1);
+            BoxList bl(bx);
+            for (const int j : before)
+            {
+                newbl.clear();
+                for (const Box& b : bl) {
+                    newbl.join(amrex::boxDiff(b, (*this)[j]));
                 }
+                std::swap(bl,newbl);
+                if (bl.isEmpty()) break;
             }
+            pieces[i] = std::move(bl.data());
         }
     }
-#ifdef BL_MEM_PROFILING
-    m_ref->updateMemoryUsage_box(1);
-#endif
-    //
-    // We now have "holes" in our BoxArray. Make us good.
-    //
+
     BoxList bl(ixType());
-    for (const auto& b : m_ref->m_abox) {
-        if (b.ok()) {
-            bl.push_back(b);
-        }
+    for (const auto& v : pieces) {
+        bl.join(v);
     }
     
     if (simplify) {
@@ -1129,10 +1881,6 @@ BoxArray::removeOverlap (bool simplify)
 
     *this = nba;
 
-#ifdef BL_MEM_PROFILING
-    m_ref->total_hash_bytes = total_hash_bytes_save;
-#endif
-
     BL_ASSERT(isDisjoint());
 }
 
@@ -1141,7 +1889,7 @@ void
 BoxArray::SendBoxArray(const BoxArray &ba, int whichSidecar)
 {
     const int MPI_IntraGroup_Broadcast_Rank = ParallelDescriptor::IOProcessor() ? MPI_ROOT : MPI_PROC_NULL;
-    Vector<int> ba_serial = amrex::SerializeBoxArray(ba);
+    Vector<char> ba_serial = amrex::EncodeBoxArray(ba);
     int ba_serial_size = ba_serial.size();
     ParallelDescriptor::Bcast(&ba_serial_size, 1, MPI_IntraGroup_Broadcast_Rank,
                               ParallelDescriptor::CommunicatorInter(whichSidecar));
@@ -1155,10 +1903,10 @@ BoxArray::RecvBoxArray(BoxArray &ba, int whichSidecar)
     int ba_serial_size;
     ParallelDescriptor::Bcast(&ba_serial_size, 1, 0,
                               ParallelDescriptor::CommunicatorInter(whichSidecar));
-    Vector<int> ba_serial(ba_serial_size);
+    Vector<char> ba_serial(ba_serial_size);
     ParallelDescriptor::Bcast(ba_serial.dataPtr(), ba_serial_size, 0,
                               ParallelDescriptor::CommunicatorInter(whichSidecar));
-    ba = amrex::UnSerializeBoxArray(ba_serial);
+    ba = amrex::DecodeBoxArray(ba_serial);
 }
 #endif
 
@@ -1190,6 +1938,57 @@ BoxArray::getDoiHi () const
     return m_simple ?           m_typ.ixType() : m_transformer->doiHi();
 }
 
+bool
+BoxArray::useBVH () const
+{
+    int kind = m_ref->IndexKind();
+
+    if (kind < 0)
+    {
+#ifdef _OPENMP
+    #pragma omp critical(intersections_lock)
+#endif
+        {
+            if (m_ref->index_kind < 0)
+            {
+                //
+                // The hash bins the boxes by their small end coarsened by
+                // the largest box extent.  If there are many boxes per bin
+                // that could be used, the BVH is better.
+                //
+                bool bvh = false;
+                const int N = size();
+                if (BARef::bvh_threshold > 0 && N > 1)
+                {
+                    IntVect maxext = IntVect::TheUnitVector();
+                    Box boundingbox = m_ref->m_abox[0];
+                    for (const Box& bx : m_ref->m_abox) {
+                        maxext = amrex::max(maxext, bx.size());
+                        boundingbox.minBox(bx);
+                    }
+                    boundingbox.coarsen(maxext);
+                    bvh = N > BARef::bvh_threshold * boundingbox.numPts();
+                }
+
+                if (bvh) {
+                    m_ref->buildBVH();
+#ifdef BL_MEM_PROFILING
+                    m_ref->updateMemoryUsage_bvh(1);
+#endif
+                }
+
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+                m_ref->index_kind = bvh ? 1 : 0;
+            }
+            kind = m_ref->index_kind;
+        }
+    }
+
+    return kind == 1;
+}
+
 BARef::HashType&
 BoxArray::getHashMap () const
 {
@@ -1248,7 +2047,11 @@ BoxArray::uniqify ()
 	auto p = std::make_shared<BARef>(*m_ref);
 	std::swap(m_ref,p);
     }
-    if (m_crse_ratio != 1) {
+    if (m_crse_ratio != 1 && m_ref->m_implicit) {
+        transformImplicit(*m_ref, [&] (Box b) -> Box { return b.coarsen(m_crse_ratio); });
+        m_crse_ratio = IntVect::TheUnitVector();
+        m_transformer->setCrseRatio(m_crse_ratio);
+    } else if (m_crse_ratio != 1) {
         const int N = m_ref->m_abox.size();
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -1430,9 +2233,17 @@ readBoxArray (BoxArray&     ba,
     else
     {
         BL_ASSERT(ba.size() == 0);
+        is >> std::ws;
+        std::istream::pos_type pos = is.tellg();
+        is.ignore(bl_ignore_max, '(') >> std::ws;
+        if (is.peek() == 'B') {
+            is.seekg(pos);
+            ba.readFrom(is);
+            return;
+        }
         int maxbox;
         unsigned long in_hash; // will be ignored
-        is.ignore(bl_ignore_max, '(') >> maxbox >> in_hash;
+        is >> maxbox >> in_hash;
         ba.resize(maxbox);
         for (int i = 0; i < maxbox; i++)
         {
@@ -1480,6 +2291,24 @@ BoxArray UnSerializeBoxArray(const Vector<int> &serarray)
 }
 
 
+Vector<char> EncodeBoxArray (const BoxArray& ba)
+{
+    Vector<char> buf;
+    encodeBoxes(ba, buf);
+    return buf;
+}
+
+
+BoxArray DecodeBoxArray (const Vector<char>& buf)
+{
+    if (buf.empty()) return BoxArray();
+    Vector<Box> boxes;
+    decodeBoxes(buf.dataPtr(), buf.dataPtr() + buf.size(), boxes);
+    if (boxes.empty()) return BoxArray();
+    return BoxArray(boxes.dataPtr(), boxes.size());
+}
+
+
 bool match (const BoxArray& x, const BoxArray& y)
 {
     if (x == y) {
@@ -396,80 +396,64 @@ boxDiff (const Box& b1in,
 int
 BoxList::simplify (bool best)
 {
+    int count = 0, n;
+    do {
+        n = 0;
+        for (int dir = 0; dir < BL_SPACEDIM; ++dir) {
+            n += simplify_doit(dir);
+        }
+        count += n;
+    } while (best && n > 0);
+
     std::sort(m_lbox.begin(), m_lbox.end(), [](const Box& l, const Box& r) {
-            return l.smallEnd() < r.smallEnd(); });
+            return l.smallEnd() < r.smallEnd()
+                || (l.smallEnd() == r.smallEnd() && l.bigEnd() < r.bigEnd()); });
 
-    return simplify_doit(best);
+    return count;
 }
 
 int
-BoxList::simplify_doit (bool best)
+BoxList::simplify_doit (int dir)
 {
+    const int N = size();
+    if (N < 2) return 0;
     //
-    // Try to merge adjacent boxes.
+    // Two boxes can be merged in direction dir if they have the same
+    // extent in the other directions, and touch or overlap in dir.  Sort
+    // the boxes so that those with the same extent in the other directions
+    // are next to each other, ordered by their low end in dir.  Then a
+    // sweep along each such run merges the boxes.
     //
-    int count = 0, lo[BL_SPACEDIM], hi[BL_SPACEDIM];
-
-    for (iterator bla = begin(), End = end(); bla != End; ++bla)
+    auto samerun_less = [dir] (const Box& l, const Box& r) -> bool {
+        for (int d = 0; d < BL_SPACEDIM; ++d) {
+            if (d == dir) continue;
+            if (l.smallEnd(d) != r.smallEnd(d)) return l.smallEnd(d) < r.smallEnd(d);
+            if (l.bigEnd(d)   != r.bigEnd(d)  ) return l.bigEnd(d)   < r.bigEnd(d);
+        }
+        return false;
+    };
+
+    std::sort(m_lbox.begin(), m_lbox.end(), [&] (const Box& l, const Box& r) {
+            if (samerun_less(l,r)) return true;
+            if (samerun_less(r,l)) return false;
+            return l.smallEnd(dir) < r.smallEnd(dir)
+                || (l.smallEnd(dir) == r.smallEnd(dir) && l.bigEnd(dir) < r.bigEnd(dir)); });
+
+    int count = 0;
+    int cur = 0;
+    for (int i = 1; i < N; ++i)
     {
-        const int* alo   = bla->loVect();
-        const int* ahi   = bla->hiVect();
-        //
-        // If we're not looking for the "best" we can do in one pass, we
-        // limit how far afield we look for abutting boxes.  This greatly
-        // speeds up this routine for large numbers of boxes.  It does not
-        // do quite as good a job though as full brute force.
-        //
-        const int MaxCnt = (best ? size() : 100);
-
-        iterator blb = bla + 1;
-        for (int cnt = 0; blb != End && cnt < MaxCnt; ++cnt, ++blb)
+        Box& a = m_lbox[cur];
+        Box& b = m_lbox[i];
+        if (!samerun_less(a,b) && b.smallEnd(dir) <= a.bigEnd(dir)+1)
         {
-            const int* blo = blb->loVect();
-            const int* bhi = blb->hiVect();
-            //
-            // Determine if a and b can be coalesced.
-            // They must have equal extents in all index directions
-            // except possibly one, and must abutt in that direction.
-            //
-            bool canjoin = true;
-            int  joincnt = 0;
-            for (int i = 0; i < BL_SPACEDIM; i++)
-            {
-                if (alo[i]==blo[i] && ahi[i]==bhi[i])
-                {
-                    lo[i] = alo[i];
-                    hi[i] = ahi[i];
-                }
-                else if (alo[i]<=blo[i] && blo[i]<=ahi[i]+1)
-                {
-                    lo[i] = alo[i];
-                    hi[i] = std::max(ahi[i],bhi[i]);
-                    joincnt++;
-                }
-                else if (blo[i]<=alo[i] && alo[i]<=bhi[i]+1)
-                {
-                    lo[i] = blo[i];
-                    hi[i] = std::max(ahi[i],bhi[i]);
-                    joincnt++;
-                }
-                else
-                {
-                    canjoin = false;
-                    break;
-                }
-            }
-            if (canjoin && (joincnt <= 1))
-            {
-                //
-                // Modify b and set a to empty
-                //
-                blb->setSmall(IntVect(lo));
-                blb->setBig(IntVect(hi));
-                *bla = Box();
-                ++count;
-                break;
-            }
+            a.setBig(dir, std::max(a.bigEnd(dir), b.bigEnd(dir)));
+            b = Box();
+            ++count;
+        }
+        else
+        {
+            cur = i;
         }
     }
 
@@ -24,6 +24,12 @@ CArena::~CArena ()
         ::operator delete(m_alloc[i]);
 }
 
+void*
+CArena::allocate_hunk (size_t& N)
+{
+    return ::operator new(N);
+}
+
 void*
 CArena::alloc (size_t nbytes)
 {
@@ -41,15 +47,15 @@ CArena::alloc (size_t nbytes)
 
     if (free_it == m_freelist.end())
     {
-        const size_t N = nbytes < m_hunk ? m_hunk : nbytes;
+        size_t N = nbytes < m_hunk ? m_hunk : nbytes;
 
-        vp = ::operator new(N);
+        vp = allocate_hunk(N);
 
         m_used += N;
 
         m_alloc.push_back(vp);
 
-        if (nbytes < m_hunk)
+        if (nbytes < N)
         {
             //
             // Add leftover chunk to free list.
@@ -58,7 +64,7 @@ CArena::alloc (size_t nbytes)
             //
             void* block = static_cast<char*>(vp) + nbytes;
 
-            m_freelist.insert(m_freelist.end(), Node(block, m_hunk-nbytes));
+            m_freelist.insert(m_freelist.end(), Node(block, N-nbytes));
         }
     }
     else
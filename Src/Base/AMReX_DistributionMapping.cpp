@@ -1,6 +1,7 @@
 
 #include <AMReX_BoxArray.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_LayoutData.H>
 #include <AMReX_DistributionMapping.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_BLProfiler.H>
@@ -23,6 +24,9 @@
 #include <numeric>
 #include <string>
 #include <cstring>
+#include <set>
+#include <functional>
+#include <tuple>
 #include <iomanip>
 
 namespace amrex {
@@ -42,6 +46,11 @@ namespace amrex {
     int    sfc_threshold;
     Real   max_efficiency;
     int    node_size;
+    Real   rebalance_tolerance;
+    int    parallel_sort_threshold;
+    int    topology_aware;
+
+    Vector<int> topology_order;
 
 // We default to SFC.
 DistributionMapping::Strategy DistributionMapping::m_Strategy = DistributionMapping::SFC;
@@ -91,6 +100,9 @@ DistributionMapping::strategy (DistributionMapping::Strategy how)
     case RRSFC:
         m_BuildMap = &DistributionMapping::RRSFCProcessorMap;
         break;
+    case GRAPH:
+        m_BuildMap = &DistributionMapping::GraphProcessorMap;
+        break;
     default:
         amrex::Error("Bad DistributionMapping::Strategy");
     }
@@ -108,6 +120,18 @@ DistributionMapping::SFC_Threshold ()
     return sfc_threshold;
 }
 
+void
+DistributionMapping::ParallelSort_Threshold (int n)
+{
+    parallel_sort_threshold = n;
+}
+
+int
+DistributionMapping::ParallelSort_Threshold ()
+{
+    return parallel_sort_threshold;
+}
+
 bool
 DistributionMapping::operator== (const DistributionMapping& rhs) const
 {
@@ -131,6 +155,9 @@ DistributionMapping::Initialize ()
     sfc_threshold    = 0;
     max_efficiency   = 0.9;
     node_size        = 0;
+    rebalance_tolerance = 0.1;
+    parallel_sort_threshold = 100000;
+    topology_aware   = 0;
 
     ParmParse pp("DistributionMapping");
 
@@ -139,6 +166,9 @@ DistributionMapping::Initialize ()
     pp.query("efficiency",       max_efficiency);
     pp.query("sfc_threshold",    sfc_threshold);
     pp.query("node_size",        node_size);
+    pp.query("rebalance_tolerance", rebalance_tolerance);
+    pp.query("parallel_sort_threshold", parallel_sort_threshold);
+    pp.query("topology_aware",   topology_aware);
 
     std::string theStrategy;
 
@@ -165,6 +195,10 @@ DistributionMapping::Initialize ()
         {
             strategy(RRSFC);
         }
+        else if (theStrategy == "GRAPH")
+        {
+            strategy(GRAPH);
+        }
         else
         {
             std::string msg("Unknown strategy: ");
@@ -202,6 +236,8 @@ DistributionMapping::Finalize ()
     initialized = false;
 
     DistributionMapping::m_BuildMap = 0;
+
+    topology_order.clear();
 }
 
 void
@@ -586,6 +622,138 @@ DistributionMapping::RoundRobinProcessorMap (const std::vector<long>& wgts,
     RoundRobinDoIt(wgts.size(), nprocs, &LIpairV);
 }
 
+#ifdef BL_USE_MPI
+namespace
+{
+    //
+    // Gathers the items of all processes, in the order of the ranks.
+    // T must be trivially copyable.
+    //
+    template <class T>
+    std::vector<T>
+    AllGatherItems (const std::vector<T>& items)
+    {
+        const int nprocs = ParallelDescriptor::NProcs();
+
+        int nbytes = items.size()*sizeof(T);
+        std::vector<int> rcnt(nprocs), rdsp(nprocs,0);
+        MPI_Allgather(&nbytes, 1, MPI_INT, rcnt.data(), 1, MPI_INT,
+                      ParallelDescriptor::Communicator());
+        for (int i = 1; i < nprocs; ++i) {
+            rdsp[i] = rdsp[i-1] + rcnt[i-1];
+        }
+
+        std::vector<T> r((rdsp[nprocs-1]+rcnt[nprocs-1])/sizeof(T));
+        MPI_Allgatherv(const_cast<T*>(items.data()), nbytes, MPI_BYTE,
+                       r.data(), rcnt.data(), rdsp.data(), MPI_BYTE,
+                       ParallelDescriptor::Communicator());
+        return r;
+    }
+
+    //
+    // Parallel sample sort.  On entry each process has its share of the
+    // items.  On exit the items of process i are sorted and precede
+    // those of process i+1.  As long as cmp is a total order, the
+    // concatenation is the same as a serial sort of all the items.
+    //
+    template <class T, class Compare>
+    void
+    SampleSort (std::vector<T>& items, Compare cmp)
+    {
+        BL_PROFILE("SampleSort()");
+
+        const int nprocs = ParallelDescriptor::NProcs();
+
+        std::sort(items.begin(), items.end(), cmp);
+
+        // Regular samples of the local items.  Their number is capped so
+        // that the gathered samples stay small on many processes.
+        const int nsamples = std::min(nprocs-1, 64);
+        const long n = items.size();
+        std::vector<T> samples;
+        if (n > 0) {
+            for (int k = 1; k <= nsamples; ++k) {
+                samples.push_back(items[(k*n)/(nsamples+1)]);
+            }
+        }
+
+        std::vector<T> allsamples = AllGatherItems(samples);
+        std::sort(allsamples.begin(), allsamples.end(), cmp);
+
+        // Process i gets the items in (splitter[i-1], splitter[i]].
+        std::vector<int> scnt(nprocs,0), sdsp(nprocs,0);
+        {
+            const long ns = allsamples.size();
+            typename std::vector<T>::const_iterator lo = items.begin();
+            for (int i = 0; i < nprocs; ++i)
+            {
+                typename std::vector<T>::const_iterator hi = items.end();
+                if (i < nprocs-1 && ns > 0) {
+                    hi = std::upper_bound(lo, hi, allsamples[((i+1)*ns)/nprocs], cmp);
+                }
+                scnt[i] = (hi-lo)*sizeof(T);
+                if (i > 0) sdsp[i] = sdsp[i-1] + scnt[i-1];
+                lo = hi;
+            }
+        }
+
+        std::vector<int> rcnt(nprocs), rdsp(nprocs,0);
+        MPI_Alltoall(scnt.data(), 1, MPI_INT, rcnt.data(), 1, MPI_INT,
+                     ParallelDescriptor::Communicator());
+        for (int i = 1; i < nprocs; ++i) {
+            rdsp[i] = rdsp[i-1] + rcnt[i-1];
+        }
+
+        std::vector<T> r((rdsp[nprocs-1]+rcnt[nprocs-1])/sizeof(T));
+        MPI_Alltoallv(items.data(), scnt.data(), sdsp.data(), MPI_BYTE,
+                      r.data(), rcnt.data(), rdsp.data(), MPI_BYTE,
+                      ParallelDescriptor::Communicator());
+
+        std::sort(r.begin(), r.end(), cmp);
+        items.swap(r);
+    }
+}
+#endif
+
+//
+// Sorts items, which every process has, with a parallel sample sort if
+// there are enough of them.  The result is the same either way.  Every
+// process needs the whole order for the cuts along it and for the full
+// processor map, so the order is gathered again; since all processes
+// already have the items, only their positions are sorted and sent.
+//
+template <class T, class Compare>
+static
+void
+SortAll (std::vector<T>& items, Compare cmp)
+{
+#ifdef BL_USE_MPI
+    const int nprocs = ParallelDescriptor::NProcs();
+    const long N = items.size();
+    if (nprocs > 1 && N >= parallel_sort_threshold)
+    {
+        const int myproc = ParallelDescriptor::MyProc();
+        std::vector<int> mine;
+        mine.reserve(((myproc+1)*N)/nprocs - (myproc*N)/nprocs);
+        for (long i = (myproc*N)/nprocs; i < ((myproc+1)*N)/nprocs; ++i) {
+            mine.push_back(i);
+        }
+        SampleSort(mine, [&items,&cmp] (int a, int b) { return cmp(items[a], items[b]); });
+        const std::vector<int> ord = AllGatherItems(mine);
+        BL_ASSERT(static_cast<long>(ord.size()) == N);
+
+        std::vector<T> sorted;
+        sorted.reserve(N);
+        for (int i : ord) {
+            sorted.push_back(items[i]);
+        }
+        items.swap(sorted);
+        return;
+    }
+#endif
+    std::sort(items.begin(), items.end(), cmp);
+}
+
 class WeightedBox
 {
     int  m_boxid;
@@ -598,7 +766,8 @@ public:
 
     bool operator< (const WeightedBox& rhs) const
     {
-        return weight() > rhs.weight();
+        return weight() > rhs.weight()
+            || (weight() == rhs.weight() && boxid() < rhs.boxid());
     }
 };
 
@@ -655,7 +824,7 @@ knapsack (const std::vector<long>&         wgts,
         lb.push_back(WeightedBox(i, wgts[i]));
     }
     BL_ASSERT(lb.size() == wgts.size());
-    std::sort(lb.begin(), lb.end());
+    SortAll(lb, std::less<WeightedBox>());
     BL_ASSERT(lb.size() == wgts.size());
     //
     // For each ball, starting with heaviest, assign ball to the lightest box.
@@ -947,6 +1116,8 @@ namespace
                               const SFCToken& rhs) const;
         };
 
+        SFCToken () {}
+
         SFCToken (int box, const IntVect& idx, Real vol)
             :
             m_box(box), m_idx(idx), m_vol(vol) {}
@@ -984,7 +1155,74 @@ SFCToken::Compare::operator () (const SFCToken& lhs,
             }
         }
     }
-    return false;
+    return lhs.m_box < rhs.m_box;
+}
+
+//
+// The ranks ordered by node, then by socket within the node, then by
+// rank.  With MPI-3 the nodes are the shared-memory groups found by
+// MPI_Comm_split_type.  Sockets are only known with Open MPI; elsewhere
+// a node is treated as one socket.
+//
+static
+const Vector<int>&
+TopologyOrder ()
+{
+    if (topology_order.empty())
+    {
+        BL_PROFILE("DistributionMapping::TopologyOrder()");
+
+        const int nprocs = ParallelDescriptor::NProcs();
+        const int myproc = ParallelDescriptor::MyProc();
+
+        int node = myproc, socket = myproc;  // identified by their lowest rank
+
+#if defined(BL_USE_MPI) && defined(BL_USE_MPI3)
+        MPI_Comm node_comm;
+        MPI_Comm_split_type(ParallelDescriptor::Communicator(), MPI_COMM_TYPE_SHARED,
+                            myproc, MPI_INFO_NULL, &node_comm);
+        MPI_Allreduce(&myproc, &node, 1, MPI_INT, MPI_MIN, node_comm);
+#if defined(OPEN_MPI) && (OMPI_MAJOR_VERSION >= 2)
+        MPI_Comm socket_comm;
+        MPI_Comm_split_type(node_comm, OMPI_COMM_TYPE_SOCKET,
+                            myproc, MPI_INFO_NULL, &socket_comm);
+        MPI_Allreduce(&myproc, &socket, 1, MPI_INT, MPI_MIN, socket_comm);
+        MPI_Comm_free(&socket_comm);
+#else
+        socket = node;
+#endif
+        MPI_Comm_free(&node_comm);
+#endif
+
+        Vector<int> where(2*nprocs);
+#ifdef BL_USE_MPI
+        int mine[2] = {node, socket};
+        MPI_Allgather(mine, 2, MPI_INT, where.dataPtr(), 2, MPI_INT,
+                      ParallelDescriptor::Communicator());
+#else
+        where[0] = node;
+        where[1] = socket;
+#endif
+
+        topology_order.resize(nprocs);
+        std::iota(topology_order.begin(), topology_order.end(), 0);
+        std::sort(topology_order.begin(), topology_order.end(), [&] (int a, int b)
+                  { return std::make_tuple(where[2*a],where[2*a+1],a)
+                         < std::make_tuple(where[2*b],where[2*b+1],b); });
+
+        if (verbose && ParallelDescriptor::IOProcessor())
+        {
+            std::set<int> nodes, sockets;
+            for (int i = 0; i < nprocs; ++i) {
+                nodes.insert(where[2*i]);
+                sockets.insert(where[2*i+1]);
+            }
+            std::cout << "DistributionMapping topology: " << nodes.size() << " nodes, "
+                      << sockets.size() << " sockets\n";
+        }
+    }
+
+    return topology_order;
 }
 
 static
@@ -1051,7 +1289,7 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
     if (ParallelDescriptor::NColors() > 1) 
 	amrex::Abort("Team and color together are not supported yet");
 #else
-    if (node_size > 0) {
+    if (node_size > 0 && !topology_aware) {
 	nteams = nprocs/node_size;
 	nworkers = node_size;
 	if (nworkers*nteams != nprocs) {
@@ -1091,7 +1329,7 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
     //
     // Put'm in Morton space filling curve order.
     //
-    std::sort(tokens.begin(), tokens.end(), SFCToken::Compare());
+    SortAll(tokens, SFCToken::Compare());
     //
     // Split'm up as equitably as possible per team.
     //
@@ -1123,7 +1361,12 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
         LIpairV.push_back(LIpair(wgt,i));
     }
 
-    Sort(LIpairV, true);
+    const bool use_topology = topology_aware && nteams == nprocs
+                              && ParallelDescriptor::NColors() == 1;
+
+    if (!use_topology) {
+        Sort(LIpairV, true);
+    }
 
     // LIpairV has a size of nteams and LIpairV[] is pair whose first is weight
     // and second is an index into vec.  LIpairV is sorted by weight such that
@@ -1132,7 +1375,11 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
     Vector<int> ord;
     Vector<Vector<int> > wrkerord;
 
-    if (nteams == nprocs) {
+    if (use_topology) {
+        // Pieces next to each other on the curve go to ranks next to each
+        // other on the same socket and node.
+        ord = TopologyOrder();
+    } else if (nteams == nprocs) {
 	LeastUsedCPUs(nprocs,ord);
     } else {
 	LeastUsedTeams(ord,wrkerord,nteams,nworkers);
@@ -1231,7 +1478,7 @@ DistributionMapping::SFCProcessorMap (const BoxArray& boxes,
 
         wgts.reserve(boxes.size());
 
-	for (int i = 0, N = boxes.size(); i < N; ++i)
+        for (int i = 0, N = boxes.size(); i < N; ++i)
         {
             wgts.push_back(boxes[i].volume());
         }
@@ -1303,7 +1550,7 @@ DistributionMapping::RRSFCDoIt (const BoxArray&          boxes,
     //
     // Put'm in Morton space filling curve order.
     //
-    std::sort(tokens.begin(), tokens.end(), SFCToken::Compare());
+    SortAll(tokens, SFCToken::Compare());
 
     Vector<int> ord;
 
@@ -1326,6 +1573,594 @@ DistributionMapping::RRSFCProcessorMap (const BoxArray&          boxes,
     RRSFCDoIt(boxes,nprocs);
 }
 
+namespace
+{
+    //
+    // An undirected graph in compressed sparse row format.  The neighbors
+    // of vertex i are adjncy[xadj[i]] ... adjncy[xadj[i+1]-1].
+    //
+    struct BoxGraph
+    {
+        std::vector<int>  xadj;
+        std::vector<int>  adjncy;
+        std::vector<long> adjwgt;
+        std::vector<long> vwgt;
+
+        int size () const { return vwgt.size(); }
+    };
+
+    //
+    // Vertices are boxes weighted by wgts; edges connect boxes that are
+    // within one cell of each other and are weighted by the number of
+    // ghost cells one box gets from the other.
+    //
+    BoxGraph
+    makeBoxGraph (const BoxArray& boxes, const std::vector<long>& wgts)
+    {
+        const int N = boxes.size();
+        BoxGraph g;
+        g.vwgt = wgts;
+        g.xadj.reserve(N+1);
+        g.xadj.push_back(0);
+
+        std::vector< std::pair<int,Box> > isects;
+
+        for (int i = 0; i < N; ++i)
+        {
+            boxes.intersections(amrex::grow(boxes[i],1), isects);
+            std::sort(isects.begin(), isects.end(),
+                      [] (const std::pair<int,Box>& a, const std::pair<int,Box>& b)
+                      { return a.first < b.first; });
+            for (const auto& is : isects)
+            {
+                if (is.first != i) {
+                    g.adjncy.push_back(is.first);
+                    g.adjwgt.push_back(is.second.numPts());
+                }
+            }
+            g.xadj.push_back(g.adjncy.size());
+        }
+
+        return g;
+    }
+
+    //
+    // The subgraph induced by verts.
+    //
+    BoxGraph
+    subGraph (const BoxGraph& g, const std::vector<int>& verts, std::vector<int>& lid)
+    {
+        BoxGraph s;
+        s.xadj.reserve(verts.size()+1);
+        s.xadj.push_back(0);
+        for (int k = 0, n = verts.size(); k < n; ++k) {
+            lid[verts[k]] = k;
+        }
+        for (int v : verts)
+        {
+            s.vwgt.push_back(g.vwgt[v]);
+            for (int e = g.xadj[v]; e < g.xadj[v+1]; ++e) {
+                const int u = lid[g.adjncy[e]];
+                if (u >= 0) {
+                    s.adjncy.push_back(u);
+                    s.adjwgt.push_back(g.adjwgt[e]);
+                }
+            }
+            s.xadj.push_back(s.adjncy.size());
+        }
+        for (int v : verts) {
+            lid[v] = -1;
+        }
+        return s;
+    }
+
+    //
+    // Coarsen by heavy-edge matching.  Fine vertex v becomes coarse vertex cmap[v].
+    //
+    BoxGraph
+    coarsenGraph (const BoxGraph& g, std::vector<int>& cmap, long maxvwgt)
+    {
+        const int n = g.size();
+
+        // Visit the vertices with fewer neighbors first so they are not left unmatched.
+        std::vector<int> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&] (int a, int b)
+                         { return g.xadj[a+1]-g.xadj[a] < g.xadj[b+1]-g.xadj[b]; });
+
+        std::vector<int> match(n,-1);
+        for (int v : order)
+        {
+            if (match[v] >= 0) continue;
+            int  best  = v;
+            long bestw = -1;
+            for (int e = g.xadj[v]; e < g.xadj[v+1]; ++e) {
+                const int u = g.adjncy[e];
+                if (match[u] < 0 && g.adjwgt[e] > bestw && g.vwgt[v]+g.vwgt[u] <= maxvwgt) {
+                    best  = u;
+                    bestw = g.adjwgt[e];
+                }
+            }
+            match[v] = best;
+            match[best] = v;
+        }
+
+        cmap.assign(n,-1);
+        std::vector<int> members;  // fine vertices of coarse vertex c are members[2c] and members[2c+1]
+        members.reserve(n+1);
+        int nc = 0;
+        for (int v = 0; v < n; ++v) {
+            if (cmap[v] < 0) {
+                cmap[v] = cmap[match[v]] = nc++;
+                members.push_back(v);
+                members.push_back(match[v]);
+            }
+        }
+
+        BoxGraph c;
+        c.vwgt.assign(nc,0);
+        c.xadj.reserve(nc+1);
+        c.xadj.push_back(0);
+        std::vector<int> pos(nc,-1);
+        for (int cv = 0; cv < nc; ++cv)
+        {
+            const int start = c.adjncy.size();
+            for (int k = 0; k < 2; ++k)
+            {
+                const int v = members[2*cv+k];
+                if (k == 1 && v == members[2*cv]) break;
+                c.vwgt[cv] += g.vwgt[v];
+                for (int e = g.xadj[v]; e < g.xadj[v+1]; ++e) {
+                    const int cu = cmap[g.adjncy[e]];
+                    if (cu == cv) continue;
+                    if (pos[cu] >= start) {
+                        c.adjwgt[pos[cu]] += g.adjwgt[e];
+                    } else {
+                        pos[cu] = c.adjncy.size();
+                        c.adjncy.push_back(cu);
+                        c.adjwgt.push_back(g.adjwgt[e]);
+                    }
+                }
+            }
+            c.xadj.push_back(c.adjncy.size());
+        }
+
+        return c;
+    }
+
+    long
+    edgeCut (const BoxGraph& g, const std::vector<char>& side)
+    {
+        long cut = 0;
+        for (int v = 0, n = g.size(); v < n; ++v) {
+            for (int e = g.xadj[v]; e < g.xadj[v+1]; ++e) {
+                if (side[v] != side[g.adjncy[e]]) cut += g.adjwgt[e];
+            }
+        }
+        return cut/2;
+    }
+
+    //
+    // Greedy boundary refinement of a bisection.  Side 0 should weigh
+    // target0 within tol.  Vertices are moved if that reduces the edge cut
+    // without violating the balance, or if it improves the balance.
+    //
+    void
+    refineBisection (const BoxGraph& g, std::vector<char>& side, long target0, long tol)
+    {
+        const int n = g.size();
+
+        long w0 = 0;
+        std::vector<long> ext(n,0), itl(n,0);
+        for (int v = 0; v < n; ++v)
+        {
+            if (side[v] == 0) w0 += g.vwgt[v];
+            for (int e = g.xadj[v]; e < g.xadj[v+1]; ++e) {
+                if (side[v] == side[g.adjncy[e]]) {
+                    itl[v] += g.adjwgt[e];
+                } else {
+                    ext[v] += g.adjwgt[e];
+                }
+            }
+        }
+
+        for (int pass = 0; pass < 8; ++pass)
+        {
+            int nmoved = 0;
+            for (int v = 0; v < n; ++v)
+            {
+                const long dw   = (side[v] == 0) ? -g.vwgt[v] : g.vwgt[v];
+                const long imb  = std::abs(w0 - target0);
+                const long imb1 = std::abs(w0 + dw - target0);
+                const long gain = ext[v] - itl[v];
+
+                bool move;
+                if (imb > tol) {
+                    move = imb1 < imb && (ext[v] > 0 || gain >= 0);
+                } else {
+                    move = imb1 <= tol && (gain > 0 || (gain == 0 && ext[v] > 0 && imb1 < imb));
+                }
+
+                if (move)
+                {
+                    side[v] = 1 - side[v];
+                    w0 += dw;
+                    std::swap(ext[v], itl[v]);
+                    for (int e = g.xadj[v]; e < g.xadj[v+1]; ++e) {
+                        const int u = g.adjncy[e];
+                        if (side[u] == side[v]) {
+                            ext[u] -= g.adjwgt[e];
+                            itl[u] += g.adjwgt[e];
+                        } else {
+                            ext[u] += g.adjwgt[e];
+                            itl[u] -= g.adjwgt[e];
+                        }
+                    }
+                    ++nmoved;
+                }
+            }
+            if (nmoved == 0) break;
+        }
+    }
+
+    //
+    // Bisect by growing side 0 from seed, always adding the vertex most
+    // strongly connected to it, until it weighs about target0.
+    //
+    std::vector<char>
+    growBisection (const BoxGraph& g, long target0, int seed)
+    {
+        const int n = g.size();
+        std::vector<char> side(n,1);
+        std::vector<long> conn(n,0);
+        std::set<std::pair<long,int> > frontier;  // (-connection, vertex)
+
+        long w0 = 0;
+        int next = seed;
+        int scan = 0;  // for disconnected graphs
+        while (next >= 0)
+        {
+            const int v = next;
+            if (w0 > 0 && (w0 + g.vwgt[v]) - target0 > target0 - w0) break;
+
+            side[v] = 0;
+            w0 += g.vwgt[v];
+            frontier.erase(std::make_pair(-conn[v],v));
+            if (w0 >= target0) break;
+
+            for (int e = g.xadj[v]; e < g.xadj[v+1]; ++e) {
+                const int u = g.adjncy[e];
+                if (side[u] == 1) {
+                    frontier.erase(std::make_pair(-conn[u],u));
+                    conn[u] += g.adjwgt[e];
+                    frontier.insert(std::make_pair(-conn[u],u));
+                }
+            }
+
+            next = -1;
+            if (!frontier.empty()) {
+                next = frontier.begin()->second;
+            } else {
+                for ( ; scan < n; ++scan) {
+                    if (side[scan] == 1) { next = scan; break; }
+                }
+            }
+        }
+
+        return side;
+    }
+
+    //
+    // Multilevel bisection: coarsen, bisect the coarsest graph, then
+    // project back and refine on every level.
+    //
+    std::vector<char>
+    bisectGraph (const BoxGraph& g, long target0)
+    {
+        const int  coarsen_to = 40;
+        const long total = std::accumulate(g.vwgt.begin(), g.vwgt.end(), 0L);
+        const long tol   = std::max(1L, total/100);
+        const long maxvwgt = std::max(*std::max_element(g.vwgt.begin(), g.vwgt.end()),
+                                      (3*total)/(2*coarsen_to));
+
+        std::vector<BoxGraph> graphs;
+        std::vector<std::vector<int> > cmaps;
+        const BoxGraph* cur = &g;
+        while (cur->size() > coarsen_to)
+        {
+            std::vector<int> cmap;
+            BoxGraph c = coarsenGraph(*cur, cmap, maxvwgt);
+            if (10*c.size() > 9*cur->size()) break;  // not worth it
+            graphs.push_back(std::move(c));
+            cmaps.push_back(std::move(cmap));
+            cur = &graphs.back();
+        }
+
+        // Try a few seeds on the coarsest graph and keep the best.
+        const int nc = cur->size();
+        std::vector<char> side;
+        long best_cut = std::numeric_limits<long>::max();
+        long best_imb = std::numeric_limits<long>::max();
+        for (int seed : {0, nc/4, nc/2, (3*nc)/4, nc-1})
+        {
+            std::vector<char> s = growBisection(*cur, target0, seed);
+            refineBisection(*cur, s, target0, tol);
+            long w0 = 0;
+            for (int v = 0; v < nc; ++v) {
+                if (s[v] == 0) w0 += cur->vwgt[v];
+            }
+            const long imb = std::max(std::abs(w0-target0), tol);
+            const long cut = edgeCut(*cur, s);
+            if (imb < best_imb || (imb == best_imb && cut < best_cut)) {
+                best_imb = imb;
+                best_cut = cut;
+                side.swap(s);
+            }
+        }
+
+        for (int lev = cmaps.size()-1; lev >= 0; --lev)
+        {
+            const BoxGraph& fine = (lev == 0) ? g : graphs[lev-1];
+            const std::vector<int>& cmap = cmaps[lev];
+            std::vector<char> fside(fine.size());
+            for (int v = 0, n = fine.size(); v < n; ++v) {
+                fside[v] = side[cmap[v]];
+            }
+            refineBisection(fine, fside, target0, tol);
+            side.swap(fside);
+        }
+
+        return side;
+    }
+
+    //
+    // Recursive bisection of the vertices verts of g into nparts parts
+    // numbered from first_part.
+    //
+    void
+    partitionGraph (const BoxGraph& g, const std::vector<int>& verts, int nparts, int first_part,
+                    std::vector<int>& part, std::vector<int>& lid)
+    {
+        if (nparts == 1 || verts.size() <= 1)
+        {
+            for (int v : verts) {
+                part[v] = first_part;
+            }
+            return;
+        }
+
+        const int nparts0 = nparts/2;
+        const BoxGraph& s = subGraph(g, verts, lid);
+        const long total = std::accumulate(s.vwgt.begin(), s.vwgt.end(), 0L);
+        const long target0 = static_cast<long>(static_cast<double>(total)*nparts0/nparts);
+
+        const std::vector<char>& side = bisectGraph(s, target0);
+
+        std::vector<int> verts0, verts1;
+        for (int k = 0, n = verts.size(); k < n; ++k) {
+            if (side[k] == 0) {
+                verts0.push_back(verts[k]);
+            } else {
+                verts1.push_back(verts[k]);
+            }
+        }
+
+        partitionGraph(g, verts0, nparts0, first_part, part, lid);
+        partitionGraph(g, verts1, nparts-nparts0, first_part+nparts0, part, lid);
+    }
+}
+
+void
+DistributionMapping::GraphProcessorMapDoIt (const BoxArray&          boxes,
+                                            const std::vector<long>& wgts,
+                                            int                      nprocs)
+{
+    BL_PROFILE("DistributionMapping::GraphProcessorMapDoIt()");
+
+    //
+    // Recursive bisection numbers the parts so that parts next to each
+    // other in the tree are next to each other in rank.  With teams,
+    // the boxes of a team therefore tend to be close to each other.
+    //
+    const int N = boxes.size();
+
+    const BoxGraph& g = makeBoxGraph(boxes, wgts);
+
+    std::vector<int> verts(N);
+    std::iota(verts.begin(), verts.end(), 0);
+    std::vector<int> part(N,0), lid(N,-1);
+
+    partitionGraph(g, verts, nprocs, 0, part, lid);
+
+    if (topology_aware && ParallelDescriptor::NColors() == 1)
+    {
+        const Vector<int>& order = TopologyOrder();
+        for (int i = 0; i < N; ++i) {
+            m_ref->m_pmap[i] = order[part[i]];
+        }
+    }
+    else
+    {
+        for (int i = 0; i < N; ++i) {
+            m_ref->m_pmap[i] = ParallelDescriptor::Translate(part[i],m_color);
+        }
+    }
+
+    if (verbose && ParallelDescriptor::IOProcessor())
+    {
+        std::vector<long> w(nprocs,0);
+        for (int i = 0; i < N; ++i) {
+            w[part[i]] += wgts[i];
+        }
+        Real sum_wgt = std::accumulate(w.begin(), w.end(), 0L);
+        Real max_wgt = *std::max_element(w.begin(), w.end());
+
+        long cut = 0, all = 0;
+        for (int v = 0; v < N; ++v) {
+            for (int e = g.xadj[v]; e < g.xadj[v+1]; ++e) {
+                all += g.adjwgt[e];
+                if (part[v] != part[g.adjncy[e]]) cut += g.adjwgt[e];
+            }
+        }
+
+        std::cout << "GRAPH efficiency: " << (sum_wgt/(nprocs*max_wgt))
+                  << ", off-process ghost cells: " << (all > 0 ? Real(cut)/all : 0.0) << '\n';
+    }
+}
+
+void
+DistributionMapping::GraphProcessorMap (const BoxArray& boxes,
+                                        int             nprocs)
+{
+    BL_ASSERT(boxes.size() > 0);
+
+    m_ref->m_pmap.resize(boxes.size());
+
+    if (boxes.size() <= nprocs || nprocs < 2)
+    {
+        RoundRobinProcessorMap(boxes,nprocs);
+    }
+    else
+    {
+        std::vector<long> wgts;
+
+        wgts.reserve(boxes.size());
+
+        for (int i = 0, N = boxes.size(); i < N; ++i)
+        {
+            wgts.push_back(boxes[i].numPts());
+        }
+
+        GraphProcessorMapDoIt(boxes,wgts,nprocs);
+    }
+}
+
+void
+DistributionMapping::GraphProcessorMap (const BoxArray&          boxes,
+                                        const std::vector<long>& wgts,
+                                        int                      nprocs)
+{
+    BL_ASSERT(boxes.size() > 0);
+    BL_ASSERT(boxes.size() == static_cast<int>(wgts.size()));
+
+    m_ref->m_pmap.resize(wgts.size());
+
+    if (boxes.size() <= nprocs || nprocs < 2)
+    {
+        RoundRobinProcessorMap(wgts,nprocs);
+    }
+    else
+    {
+        GraphProcessorMapDoIt(boxes,wgts,nprocs);
+    }
+}
+
+void
+DistributionMapping::RebalanceProcessorMap (const DistributionMapping&  olddm,
+                                            const std::vector<long>&    wgts,
+                                            const std::vector<long>&    bytes,
+                                            int                         nprocs,
+                                            Real                        tolerance)
+{
+    BL_PROFILE("DistributionMapping::RebalanceProcessorMap()");
+
+    if (olddm.size() != static_cast<int>(wgts.size()) || wgts.size() != bytes.size()) {
+        amrex::Abort("DistributionMapping::RebalanceProcessorMap: olddm, wgts and bytes differ in size");
+    }
+
+    //
+    // Start from the old map and move boxes from the most to the least
+    // loaded CPU until the most loaded one is within (1+tolerance) of the
+    // average.  Of the boxes that can go, we move the one that removes the
+    // most excess load per byte moved.  Every move lowers the sum of the
+    // squares of the loads, so this terminates.
+    //
+    const int N = wgts.size();
+
+    m_ref->m_pmap = olddm.ProcessorMap();
+
+    std::vector<long> load(nprocs,0);
+    std::vector<std::vector<int> > pboxes(nprocs);
+    for (int i = 0; i < N; ++i)
+    {
+        const int p = m_ref->m_pmap[i];
+        if (p < 0 || p >= nprocs) {
+            amrex::Abort("DistributionMapping::RebalanceProcessorMap: olddm has a processor outside [0,nprocs)");
+        }
+        load[p] += wgts[i];
+        pboxes[p].push_back(i);
+    }
+
+    const long total = std::accumulate(wgts.begin(), wgts.end(), 0L);
+    const Real avg   = static_cast<Real>(total)/nprocs;
+    const Real limit = avg*(1.0+tolerance);
+
+    const Real old_max = *std::max_element(load.begin(), load.end());
+
+    std::set<std::pair<long,int> > byload;  // (load, cpu)
+    for (int p = 0; p < nprocs; ++p) {
+        byload.insert(std::make_pair(load[p],p));
+    }
+
+    long nbytes = 0, nbytes_total = 0;
+    int nmoved = 0;
+
+    while (true)
+    {
+        const int  p = byload.rbegin()->second;
+        const int  q = byload.begin()->second;
+        const long room = load[p] - load[q];
+
+        if (load[p] <= limit || p == q) break;
+
+        const Real excess = load[p] - avg;
+        int  best = -1;
+        Real best_score = 0.0;
+        for (int k = 0, n = pboxes[p].size(); k < n; ++k)
+        {
+            const int i = pboxes[p][k];
+            if (wgts[i] < room)
+            {
+                const Real score = std::min(static_cast<Real>(wgts[i]),excess)
+                    / static_cast<Real>(std::max(bytes[i],1L));
+                if (score > best_score) {
+                    best_score = score;
+                    best = k;
+                }
+            }
+        }
+
+        if (best < 0) break;  // nothing left on p is small enough to move
+
+        const int i = pboxes[p][best];
+        pboxes[p][best] = pboxes[p].back();
+        pboxes[p].pop_back();
+        pboxes[q].push_back(i);
+
+        byload.erase(std::make_pair(load[p],p));
+        byload.erase(std::make_pair(load[q],q));
+        load[p] -= wgts[i];
+        load[q] += wgts[i];
+        byload.insert(std::make_pair(load[p],p));
+        byload.insert(std::make_pair(load[q],q));
+
+        m_ref->m_pmap[i] = q;
+        nbytes += bytes[i];
+        ++nmoved;
+    }
+
+    if (verbose && ParallelDescriptor::IOProcessor())
+    {
+        for (int i = 0; i < N; ++i) {
+            nbytes_total += bytes[i];
+        }
+        const Real new_max = *std::max_element(load.begin(), load.end());
+        std::cout << "Rebalance efficiency: " << (avg/old_max) << " -> " << (avg/new_max)
+                  << ", moved " << nmoved << " boxes, "
+                  << (nbytes_total > 0 ? Real(nbytes)/nbytes_total : 0.0) << " of the data\n";
+    }
+}
+
 namespace
 {
     struct PFCToken
@@ -2600,6 +3435,44 @@ DistributionMapping::TranslateProcMap(const Vector<int> &pm_old, const MPI_Group
 }
 #endif
 
+namespace
+{
+    //
+    // Sum the cost of each box over the processes and scale it to integer
+    // weights from 1 to 1e9+1.  Returns the largest cost.
+    //
+    Real
+    scaleCost (Vector<Real>& rcost, Vector<long>& cost)
+    {
+        ParallelDescriptor::ReduceRealSum(rcost.dataPtr(), rcost.size());
+
+        Real wmax = *std::max_element(rcost.begin(), rcost.end());
+        Real scale = (wmax > 0.0) ? 1.e9/wmax : 1.0;
+
+        cost.resize(rcost.size());
+        for (int i = 0; i < rcost.size(); ++i) {
+            cost[i] = long(rcost[i]*scale) + 1L;
+        }
+        return wmax;
+    }
+
+    //
+    // The same for the sum of weight over the valid cells of each box.
+    //
+    Real
+    weightCost (const MultiFab& weight, Vector<long>& cost)
+    {
+        Vector<Real> rcost(weight.size(), 0.0);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(weight); mfi.isValid(); ++mfi) {
+            rcost[mfi.index()] = weight[mfi].sum(mfi.validbox(),0);
+        }
+        return scaleCost(rcost, cost);
+    }
+}
+
 DistributionMapping
 DistributionMapping::makeKnapSack (const Vector<Real>& rcost)
 {
@@ -2733,6 +3606,150 @@ DistributionMapping::makeSFC (const MultiFab& weight,
     return r;
 }
 
+DistributionMapping
+DistributionMapping::makeGraph (const MultiFab& weight,
+                                const BoxArray& boxes)
+{
+    BL_PROFILE("makeGraph");
+
+    DistributionMapping r;
+
+    Vector<long> cost;
+    weightCost(weight, cost);
+
+    int nprocs = ParallelDescriptor::NProcs();
+
+    r.GraphProcessorMap(boxes, cost, nprocs);
+
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makeRebalance (const DistributionMapping& olddm,
+                                    const MultiFab&            weight)
+{
+    return makeRebalance(olddm, weight, rebalance_tolerance);
+}
+
+DistributionMapping
+DistributionMapping::makeRebalance (const DistributionMapping& olddm,
+                                    const MultiFab&            weight,
+                                    Real                       tolerance)
+{
+    BL_PROFILE("makeRebalance");
+
+    DistributionMapping r;
+
+    const BoxArray& boxes = weight.boxArray();
+
+    Vector<long> cost;
+    const Real wmax = weightCost(weight, cost);
+
+    //
+    // Without any cost there is nothing to balance.
+    //
+    if (wmax <= 0.0) return olddm;
+
+    Vector<long> bytes(weight.size());
+
+    // The data moved with a box is proportional to its volume.
+    for (int i = 0; i < bytes.size(); ++i) {
+        bytes[i] = boxes[i].numPts();
+    }
+
+    int nprocs = ParallelDescriptor::NProcs();
+
+    r.RebalanceProcessorMap(olddm, cost, bytes, nprocs, tolerance);
+
+    return r;
+}
+
+namespace
+{
+    //
+    // The measured cost of every box, scaled to integer weights the same
+    // way as the weights from a MultiFab.
+    //
+    Vector<long>
+    scaledCost (const LayoutData<Real>& rcost_l, Real* wmax = nullptr)
+    {
+        Vector<Real> rcost(rcost_l.size(), 0.0);
+        for (MFIter mfi(rcost_l); mfi.isValid(); ++mfi) {
+            rcost[mfi.index()] = rcost_l[mfi];
+        }
+
+        Vector<long> cost;
+        const Real w = scaleCost(rcost, cost);
+        if (wmax) *wmax = w;
+        return cost;
+    }
+}
+
+DistributionMapping
+DistributionMapping::makeKnapSack (const LayoutData<Real>& rcost, int nmax)
+{
+    BL_PROFILE("makeKnapSack");
+
+    DistributionMapping r;
+
+    const Vector<long> cost = scaledCost(rcost);
+
+    int nprocs = ParallelDescriptor::NProcs();
+    Real eff;
+
+    r.KnapSackProcessorMap(cost, nprocs, &eff, true, nmax);
+
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makeSFC (const LayoutData<Real>& rcost)
+{
+    BL_PROFILE("makeSFC");
+
+    DistributionMapping r;
+
+    const Vector<long> cost = scaledCost(rcost);
+
+    int nprocs = ParallelDescriptor::NProcs();
+
+    r.SFCProcessorMap(rcost.boxArray(), cost, nprocs);
+
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makeRebalance (const LayoutData<Real>& rcost)
+{
+    return makeRebalance(rcost, rebalance_tolerance);
+}
+
+DistributionMapping
+DistributionMapping::makeRebalance (const LayoutData<Real>& rcost, Real tolerance)
+{
+    BL_PROFILE("makeRebalance");
+
+    DistributionMapping r;
+
+    const BoxArray& boxes = rcost.boxArray();
+
+    Real wmax;
+    const Vector<long> cost = scaledCost(rcost, &wmax);
+
+    if (wmax <= 0.0) return rcost.DistributionMap();
+
+    Vector<long> bytes(boxes.size());
+    for (int i = 0; i < bytes.size(); ++i) {
+        bytes[i] = boxes[i].numPts();
+    }
+
+    int nprocs = ParallelDescriptor::NProcs();
+
+    r.RebalanceProcessorMap(rcost.DistributionMap(), cost, bytes, nprocs, tolerance);
+
+    return r;
+}
+
 std::ostream&
 operator<< (std::ostream&              os,
             const DistributionMapping& pmap)
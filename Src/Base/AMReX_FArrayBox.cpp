@@ -194,6 +194,33 @@ FArrayBox::initVal ()
     }
 }
 
+void
+FArrayBox::initVal (const Box& bx, int scomp, int ncomp)
+{
+    BL_ASSERT(domain.contains(bx));
+    BL_ASSERT(scomp >= 0 && scomp + ncomp <= nvar);
+
+#ifdef BL_USE_DOUBLE
+    if (init_snan)
+    {
+        //
+        // One row at a time, so the NaNs stay signaling.
+        //
+        const long len = bx.length(0);
+        Box rows(bx);
+        rows.setBig(0, bx.smallEnd(0));
+        for (int n = scomp; n < scomp+ncomp; ++n) {
+            for (IntVect iv = rows.smallEnd(); iv <= rows.bigEnd(); rows.next(iv)) {
+                amrex_array_init_snan(dataPtr(n) + domain.index(iv), len);
+            }
+        }
+        return;
+    }
+#endif
+
+    setVal(do_initval ? initval : 0.0, bx, scomp, ncomp);
+}
+
 bool 
 FArrayBox::contains_nan () const
 {
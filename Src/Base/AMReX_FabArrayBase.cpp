@@ -4,6 +4,14 @@
 #include <AMReX_Utility.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_FArrayBox.H>
+#include <AMReX_NFiles.H>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <fstream>
+#include <sstream>
 
 #ifdef BL_MEM_PROFILING
 #include <AMReX_MemProfiler.H>
@@ -19,6 +27,14 @@ namespace amrex {
 // Set default values in Initialize()!!!
 //
 bool    FabArrayBase::do_async_sends;
+bool    FabArrayBase::use_persistent_comm;
+bool    FabArrayBase::use_neighbor_collectives;
+bool    FabArrayBase::use_node_aggregation;
+bool    FabArrayBase::checkpoint_comm_metadata;
+bool    FabArrayBase::numa_first_touch;
+long    FabArrayBase::comm_chunk_bytes;
+long    FabArrayBase::cache_max_bytes;
+MPI_Comm FabArrayBase::persistent_comm = MPI_COMM_NULL;
 int     FabArrayBase::MaxComp;
 #if BL_SPACEDIM == 1
 IntVect FabArrayBase::mfiter_tile_size(1024000);
@@ -44,6 +60,14 @@ FabArrayBase::CacheStats           FabArrayBase::m_CPC_stats("CopyCache");
 FabArrayBase::CacheStats           FabArrayBase::m_FPinfo_stats("FillPatchCache");
 FabArrayBase::CacheStats           FabArrayBase::m_CFinfo_stats("CrseFineCache");
 
+std::atomic<long>                  FabArrayBase::m_cache_tick(0);
+std::vector<MPI_Comm>              FabArrayBase::m_retired_comms;
+
+std::multimap<FabArrayBase::BDHash,FabArrayBase::FB*>                                   FabArrayBase::m_LoadedFB;
+std::multimap<std::pair<FabArrayBase::BDHash,FabArrayBase::BDHash>,FabArrayBase::CPC*>    FabArrayBase::m_LoadedCPC;
+std::multimap<std::pair<FabArrayBase::BDHash,FabArrayBase::BDHash>,FabArrayBase::FPinfo*> FabArrayBase::m_LoadedFPinfo;
+std::map<FabArrayBase::BDHash,FabArrayBase::LoadedBD>                                     FabArrayBase::m_LoadedBD;
+
 std::map<FabArrayBase::BDKey, int> FabArrayBase::m_BD_count;
 
 FabArrayBase::FabArrayStats        FabArrayBase::m_FA_stats;
@@ -51,6 +75,84 @@ FabArrayBase::FabArrayStats        FabArrayBase::m_FA_stats;
 namespace
 {
     bool initialized = false;
+
+    // Do the BoxArrays have the same boxes and the DistributionMappings the same map?
+    bool sameBD (const BoxArray& ba1, const DistributionMapping& dm1,
+                 const BoxArray& ba2, const DistributionMapping& dm2)
+    {
+        if (ba1.size() != ba2.size() || ba1.ixType() != ba2.ixType() || dm1 != dm2) {
+            return false;
+        }
+        if (ba1 == ba2) return true;
+        for (int i = 0, N = ba1.size(); i < N; ++i) {
+            if (ba1[i] != ba2[i]) return false;
+        }
+        return true;
+    }
+
+    // FNV-1a hash of the boxes and the processor map.  It keys the items
+    // read by readCommMetaData and their BoxArrays and DistributionMappings.
+    unsigned long long hashBD (const BoxArray& ba, const DistributionMapping& dm)
+    {
+        unsigned long long h = 14695981039346656037ULL;
+        auto mix = [&h] (int v) {
+            h ^= static_cast<unsigned int>(v);
+            h *= 1099511628211ULL;
+        };
+        for (int idim = 0; idim < BL_SPACEDIM; ++idim) {
+            mix(ba.ixType().nodeCentered(idim));
+        }
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            const Box& bx = ba[i];
+            for (int idim = 0; idim < BL_SPACEDIM; ++idim) {
+                mix(bx.smallEnd(idim));
+                mix(bx.bigEnd(idim));
+            }
+        }
+        for (int p : dm.ProcessorMap()) {
+            mix(p);
+        }
+        return h;
+    }
+
+    FabFactory<FArrayBox>* makeCrsePatchFactory (const BoxArray& ba,
+                                                 const DistributionMapping& dm,
+                                                 const Box& cdomain)
+    {
+#ifdef AMREX_USE_EB
+        return new EBFArrayBoxFactory(Geometry(cdomain), ba, dm, {0,0,0}, EBSupport::basic);
+#else
+        return new FArrayBoxFactory();
+#endif
+    }
+
+    // Are FillBoundary messages aggregated per pair of teams?  Only for
+    // cell-centered data, because shared nodes and faces could otherwise be
+    // unpacked by two processes of a team at the same time.
+    bool aggregateTeams (const IndexType& typ)
+    {
+        return FabArrayBase::use_node_aggregation && ParallelDescriptor::TeamSize() > 1
+            && typ.cellCentered();
+    }
+
+    // The member of rank's team that exchanges the aggregated messages
+    // with other_rank's team.
+    int teamPeer (int rank, int other_rank)
+    {
+        return ParallelDescriptor::TeamLead(rank)
+            + ParallelDescriptor::RankInLeadComm(other_rank) % ParallelDescriptor::TeamSize();
+    }
+
+    // The processes that send and receive the data from src_owner to dst_owner.
+    int commSender (bool agg, int src_owner, int dst_owner)
+    {
+        return agg ? teamPeer(src_owner, dst_owner) : src_owner;
+    }
+
+    int commReceiver (bool agg, int src_owner, int dst_owner)
+    {
+        return agg ? teamPeer(dst_owner, src_owner) : dst_owner;
+    }
 }
 
 
@@ -76,6 +178,13 @@ FabArrayBase::Initialize ()
     // Set default values here!!!
     //
     FabArrayBase::do_async_sends    = true;
+    FabArrayBase::use_persistent_comm = false;
+    FabArrayBase::use_neighbor_collectives = false;
+    FabArrayBase::use_node_aggregation = false;
+    FabArrayBase::comm_chunk_bytes  = 65536;
+    FabArrayBase::cache_max_bytes   = 0;
+    FabArrayBase::checkpoint_comm_metadata = false;
+    FabArrayBase::numa_first_touch  = false;
     FabArrayBase::MaxComp           = 25;
 
     ParmParse pp("fabarray");
@@ -99,12 +208,34 @@ FabArrayBase::Initialize ()
 
     pp.query("maxcomp",             FabArrayBase::MaxComp);
     pp.query("do_async_sends",      FabArrayBase::do_async_sends);
+    pp.query("use_persistent_comm", FabArrayBase::use_persistent_comm);
+    pp.query("comm_chunk_bytes",    FabArrayBase::comm_chunk_bytes);
+    pp.query("use_neighbor_collectives", FabArrayBase::use_neighbor_collectives);
+    pp.query("use_node_aggregation", FabArrayBase::use_node_aggregation);
+    pp.query("cache_max_bytes",     FabArrayBase::cache_max_bytes);
+    pp.query("checkpoint_comm_metadata", FabArrayBase::checkpoint_comm_metadata);
+    pp.query("numa_first_touch",    FabArrayBase::numa_first_touch);
 
     if (MaxComp < 1)
         MaxComp = 1;
 
+#ifndef BL_USE_MPI3
+    if (FabArrayBase::use_neighbor_collectives) {
+        amrex::Warning("fabarray.use_neighbor_collectives requires MPI-3 support; ignored");
+        FabArrayBase::use_neighbor_collectives = false;
+    }
+#endif
+
     FabArrayBase::nFabArrays = 0;
 
+#ifdef BL_USE_MPI
+    if (FabArrayBase::use_persistent_comm) {
+        // This is collective, so it cannot be done lazily by the first FillBoundary.
+        BL_MPI_REQUIRE( MPI_Comm_dup(ParallelDescriptor::Communicator(),
+                                     &FabArrayBase::persistent_comm) );
+    }
+#endif
+
     amrex::ExecOnFinalize(FabArrayBase::Finalize);
 
 #ifdef BL_MEM_PROFILING
@@ -185,6 +316,50 @@ FabArrayBase::bytesOfMapOfCopyComTagContainers (const FabArrayBase::MapOfCopyCom
     return r;
 }
 
+void
+FabArrayBase::makeCommChunks (Vector<CommChunk>&                         chunks,
+                              const Vector<char*>&                        data,
+                              const Vector<const CopyComTagsContainer*>& cctc,
+                              bool use_sbox, int ncomp, std::size_t value_size)
+{
+    BL_ASSERT(data.size() == cctc.size());
+
+    chunks.clear();
+
+    const int  ldir   = BL_SPACEDIM-1;
+    const long nbytes_chunk = comm_chunk_bytes;
+
+    for (int j = 0, N = data.size(); j < N; ++j)
+    {
+        char* dptr = data[j];
+        if (dptr == nullptr) continue;
+
+        for (auto const& tag : *cctc[j])
+        {
+            const Box& bx     = use_sbox ? tag.sbox : tag.dbox;
+            const long nbytes = bx.numPts() * ncomp * value_size;
+            const int  len    = bx.length(ldir);
+
+            int nslabs = 1;
+            if (nbytes_chunk > 0 && nbytes > nbytes_chunk) {
+                nslabs = static_cast<int>(std::min(static_cast<long>(len),
+                                                   (nbytes+nbytes_chunk-1)/nbytes_chunk));
+            }
+
+            const int lo = bx.smallEnd(ldir);
+            for (int islab = 0; islab < nslabs; ++islab)
+            {
+                // Slab sizes differ by at most one.
+                const int slo = lo + static_cast<int>((static_cast<long>(len)*islab)/nslabs);
+                const int shi = lo + static_cast<int>((static_cast<long>(len)*(islab+1))/nslabs) - 1;
+                chunks.push_back({&tag, dptr, slo, shi, nslabs > 1});
+            }
+
+            dptr += nbytes;
+        }
+    }
+}
+
 long
 FabArrayBase::CPC::bytes () const
 {
@@ -211,7 +386,7 @@ FabArrayBase::CPC::bytes () const
 long
 FabArrayBase::FB::bytes () const
 {
-    int cnt = sizeof(FabArrayBase::FB);
+    long cnt = sizeof(FabArrayBase::FB);
 
     if (m_LocTags)
 	cnt += amrex::bytesOf(*m_LocTags);
@@ -228,6 +403,12 @@ FabArrayBase::FB::bytes () const
     if (m_RcvVols)
 	cnt += FabArrayBase::bytesOfMapOfCopyComTagContainers(*m_RcvVols);
 
+    for (auto const& kv : m_persistent_plans)
+        cnt += kv.second->bytes();
+
+    for (auto const& kv : m_neighbor_plans)
+        cnt += kv.second->bytes();
+
     return cnt;
 }
 
@@ -256,8 +437,11 @@ FabArrayBase::CPC::CPC (const FabArrayBase& dstfa, int dstng,
       m_period(period),
       m_srcba(srcfa.boxArray()), 
       m_dstba(dstfa.boxArray()),
+      m_srcdm(srcfa.DistributionMap()),
+      m_dstdm(dstfa.DistributionMap()),
       m_threadsafe_loc(false), m_threadsafe_rcv(false),
-      m_LocTags(0), m_SndTags(0), m_RcvTags(0), m_SndVols(0), m_RcvVols(0), m_nuse(0)
+      m_LocTags(0), m_SndTags(0), m_RcvTags(0), m_SndVols(0), m_RcvVols(0), m_nuse(0),
+      m_last_use(0), m_npending(0)
 {
     this->define(m_dstba, dstfa.DistributionMap(), dstfa.IndexArray(), 
 		 m_srcba, srcfa.DistributionMap(), srcfa.IndexArray());
@@ -275,12 +459,27 @@ FabArrayBase::CPC::CPC (const BoxArray& dstba, const DistributionMapping& dstdm,
       m_period(period),
       m_srcba(srcba), 
       m_dstba(dstba),
+      m_srcdm(srcdm),
+      m_dstdm(dstdm),
       m_threadsafe_loc(false), m_threadsafe_rcv(false),
-      m_LocTags(0), m_SndTags(0), m_RcvTags(0), m_SndVols(0), m_RcvVols(0), m_nuse(0)
+      m_LocTags(0), m_SndTags(0), m_RcvTags(0), m_SndVols(0), m_RcvVols(0), m_nuse(0),
+      m_last_use(0), m_npending(0)
 {
     this->define(dstba, dstdm, dstidx, srcba, srcdm, srcidx, myproc);
 }
 
+FabArrayBase::CPC::CPC ()
+    : m_srcng(0),
+      m_dstng(0),
+      m_threadsafe_loc(false), m_threadsafe_rcv(false),
+      m_LocTags(new CopyComTag::CopyComTagsContainer),
+      m_SndTags(new CopyComTag::MapOfCopyComTagContainers),
+      m_RcvTags(new CopyComTag::MapOfCopyComTagContainers),
+      m_SndVols(new CopyComTag::MapOfCopyComTagContainers),
+      m_RcvVols(new CopyComTag::MapOfCopyComTagContainers),
+      m_nuse(0), m_last_use(0), m_npending(0)
+{}
+
 FabArrayBase::CPC::~CPC ()
 {
     delete m_LocTags;
@@ -316,21 +515,30 @@ FabArrayBase::CPC::define (const BoxArray& ba_dst, const DistributionMapping& dm
 	const int ng_dst = m_dstng;
 
 	std::vector< std::pair<int,Box> > isects;
+	std::vector<int> offsets;
+	std::vector<Box> qbxs;
 
 	const std::vector<IntVect>& pshifts = m_period.shiftIntVect();
+	const int npshifts = pshifts.size();
 
 	auto& send_tags = *m_SndVols;
+
+	qbxs.resize(nlocal_src);
+	for (int i = 0; i < nlocal_src; ++i) {
+	    qbxs[i] = amrex::grow(ba_src[imap_src[i]], ng_src);
+	}
+	ba_dst.intersections(qbxs, pshifts, isects, offsets, ng_dst);
 	
 	for (int i = 0; i < nlocal_src; ++i)
 	{
 	    const int   k_src = imap_src[i];
-	    const Box& bx_src = amrex::grow(ba_src[k_src], ng_src);
 
-	    for (std::vector<IntVect>::const_iterator pit=pshifts.begin(); pit!=pshifts.end(); ++pit)
+	    for (int ip = 0; ip < npshifts; ++ip)
 	    {
-		ba_dst.intersections(bx_src+(*pit), isects, false, ng_dst);
+		const auto pit = pshifts.cbegin() + ip;
+		const int k = i*npshifts + ip;
 	    
-		for (int j = 0, M = isects.size(); j < M; ++j)
+		for (int j = offsets[k], M = offsets[k+1]; j < M; ++j)
 		{
 		    const int k_dst     = isects[j].first;
 		    const Box& bx       = isects[j].second;
@@ -359,11 +567,17 @@ FabArrayBase::CPC::define (const BoxArray& ba_dst, const DistributionMapping& dm
 	if (ParallelDescriptor::TeamSize() > 1) {
 	    check_local = true;
 	}
+
+	qbxs.resize(nlocal_dst);
+	for (int i = 0; i < nlocal_dst; ++i) {
+	    qbxs[i] = amrex::grow(ba_dst[imap_dst[i]], ng_dst);
+	}
+	ba_src.intersections(qbxs, pshifts, isects, offsets, ng_src);
 	
 	for (int i = 0; i < nlocal_dst; ++i)
 	{
 	    const int   k_dst = imap_dst[i];
-	    const Box& bx_dst = amrex::grow(ba_dst[k_dst], ng_dst);
+	    const Box& bx_dst = qbxs[i];
 	    
 	    if (check_local) {
 		localtouch.resize(bx_dst);
@@ -375,11 +589,12 @@ FabArrayBase::CPC::define (const BoxArray& ba_dst, const DistributionMapping& dm
 		remotetouch.setVal(0);
 	    }
 	    
-	    for (std::vector<IntVect>::const_iterator pit=pshifts.begin(); pit!=pshifts.end(); ++pit)
+	    for (int ip = 0; ip < npshifts; ++ip)
 	    {
-		ba_src.intersections(bx_dst+(*pit), isects, false, ng_src);
+		const auto pit = pshifts.cbegin() + ip;
+		const int k = i*npshifts + ip;
 	    
-		for (int j = 0, M = isects.size(); j < M; ++j)
+		for (int j = offsets[k], M = offsets[k+1]; j < M; ++j)
 		{
 		    const int k_src     = isects[j].first;
 		    const Box& bx       = isects[j].second - *pit;
@@ -479,9 +694,7 @@ FabArrayBase::flushCPC (bool no_assertion) const
 	    }
 	}
 
-#ifdef BL_MEM_PROFILING
 	m_CPC_stats.bytes -= it->second->bytes();
-#endif
 	m_CPC_stats.recordErase(it->second->m_nuse);
 	delete it->second;
     }
@@ -506,9 +719,7 @@ FabArrayBase::flushCPCache ()
 	}
     }
     m_TheCPCache.clear();
-#ifdef BL_MEM_PROFILING
     m_CPC_stats.bytes = 0L;
-#endif
 }
 
 const FabArrayBase::CPC&
@@ -536,27 +747,66 @@ FabArrayBase::getCPC (int dstng, const FabArrayBase& src, int srcng, const Perio
 	    it->second->m_dstba  == boxArray())
 	{
 	    ++(it->second->m_nuse);
+	    it->second->m_last_use = ++m_cache_tick;
 	    m_CPC_stats.recordUse();
 	    return *(it->second);
 	}
     }
     
-    // Have to build a new one
-    CPC* new_cpc = new CPC(*this, dstng, src, srcng, period);
+    // Have to build a new one, unless readCommMetaData has it
+    CPC* new_cpc = nullptr;
 
-#ifdef BL_MEM_PROFILING
-    m_CPC_stats.bytes += new_cpc->bytes();
-    m_CPC_stats.bytes_hwm = std::max(m_CPC_stats.bytes_hwm, m_CPC_stats.bytes);
-#endif    
+    if ( ! m_LoadedCPC.empty())
+    {
+	const BDHash dsth = hashBD(    boxArray(),     DistributionMap());
+	const BDHash srch = hashBD(src.boxArray(), src.DistributionMap());
+	if (matchLoadedBD(dsth,     boxArray(),     DistributionMap()) &&
+	    matchLoadedBD(srch, src.boxArray(), src.DistributionMap()))
+	{
+	    auto range = m_LoadedCPC.equal_range(std::make_pair(dsth,srch));
+	    for (auto it = range.first; it != range.second; ++it)
+	    {
+		CPC* cpc = it->second;
+		if (cpc->m_srcng  == srcng &&
+		    cpc->m_dstng  == dstng &&
+		    cpc->m_period == period)
+		{
+		    cpc->m_srcbdk = srckey;
+		    cpc->m_dstbdk = dstkey;
+		    cpc->m_srcba  = src.boxArray();
+		    cpc->m_dstba  =     boxArray();
+		    cpc->m_srcdm  = src.DistributionMap();
+		    cpc->m_dstdm  =     DistributionMap();
+		    new_cpc = cpc;
+		    m_LoadedCPC.erase(it);
+		    releaseLoadedBD(dsth);
+		    releaseLoadedBD(srch);
+		    m_CPC_stats.recordLoad();
+		    break;
+		}
+	    }
+	}
+    }
+
+    if (new_cpc == nullptr) {
+	new_cpc = new CPC(*this, dstng, src, srcng, period);
+	m_CPC_stats.recordBuild();
+    }
+
+    m_CPC_stats.recordBytes(new_cpc->bytes());    
 
     new_cpc->m_nuse = 1;
-    m_CPC_stats.recordBuild();
+    new_cpc->m_last_use = ++m_cache_tick;
     m_CPC_stats.recordUse();
 
     m_TheCPCache.insert(er_it.second, CPCache::value_type(dstkey,new_cpc));
     if (srckey != dstkey)
 	m_TheCPCache.insert(          CPCache::value_type(srckey,new_cpc));
 
+    if (cache_max_bytes > 0 && cacheBytes() > cache_max_bytes) {
+        evictCaches(cache_max_bytes, CPCKind, new_cpc);
+    }
+
     return *new_cpc;
 }
 
@@ -568,14 +818,15 @@ FabArrayBase::FB::FB (const FabArrayBase& fa, bool cross, const Periodicity& per
 		      bool enforce_periodicity_only)
     : m_typ(fa.boxArray().ixType()), m_crse_ratio(fa.boxArray().crseRatio()),
       m_ngrow(fa.nGrow()), m_cross(cross),
-      m_epo(enforce_periodicity_only), m_period(period),
+      m_epo(enforce_periodicity_only), m_agg(aggregateTeams(fa.boxArray().ixType())), m_period(period),
+      m_ba(fa.boxArray()), m_dm(fa.DistributionMap()),
       m_threadsafe_loc(false), m_threadsafe_rcv(false),
       m_LocTags(new CopyComTag::CopyComTagsContainer),
       m_SndTags(new CopyComTag::MapOfCopyComTagContainers),
       m_RcvTags(new CopyComTag::MapOfCopyComTagContainers),
       m_SndVols(new CopyComTag::MapOfCopyComTagContainers),
       m_RcvVols(new CopyComTag::MapOfCopyComTagContainers),
-      m_nuse(0)
+      m_nuse(0), m_last_use(0)
 {
     BL_PROFILE("FabArrayBase::FB::FB()");
 
@@ -603,21 +854,29 @@ FabArrayBase::FB::define_fb(const FabArrayBase& fa)
     const int nlocal = imap.size();
     const int ng = m_ngrow;
     std::vector< std::pair<int,Box> > isects;
+    std::vector<int> offsets;
+    std::vector<Box> qbxs(nlocal);
     
     const std::vector<IntVect>& pshifts = m_period.shiftIntVect();
+    const int npshifts = pshifts.size();
     
     auto& send_tags = *m_SndVols;
+
+    for (int i = 0; i < nlocal; ++i) {
+	qbxs[i] = ba[imap[i]];
+    }
+    ba.intersections(qbxs, pshifts, isects, offsets, ng);
     
     for (int i = 0; i < nlocal; ++i)
     {
 	const int ksnd = imap[i];
-	const Box& vbx = ba[ksnd];
 	
-	for (auto pit=pshifts.cbegin(); pit!=pshifts.cend(); ++pit)
+	for (int ip = 0; ip < npshifts; ++ip)
 	{
-	    ba.intersections(vbx+(*pit), isects, false, ng);
+	    const auto pit = pshifts.cbegin() + ip;
+	    const int k = i*npshifts + ip;
 
-	    for (int j = 0, M = isects.size(); j < M; ++j)
+	    for (int j = offsets[k], M = offsets[k+1]; j < M; ++j)
 	    {
 		const int krcv      = isects[j].first;
 		const Box& bx       = isects[j].second;
@@ -625,10 +884,11 @@ FabArrayBase::FB::define_fb(const FabArrayBase& fa)
 		
 		if (ParallelDescriptor::sameTeam(dst_owner)) {
 		    continue;  // local copy will be dealt with later
-		} else if (MyProc == dm[ksnd]) {
+		} else if (MyProc == commSender(m_agg, dm[ksnd], dst_owner)) {
+		    const int rcvr = commReceiver(m_agg, dm[ksnd], dst_owner);
 		    const BoxList& bl = amrex::boxDiff(bx, ba[krcv]);
 		    for (BoxList::const_iterator lit = bl.begin(); lit != bl.end(); ++lit)
-			send_tags[dst_owner].push_back(CopyComTag(*lit, (*lit)-(*pit), krcv, ksnd));
+			send_tags[rcvr].push_back(CopyComTag(*lit, (*lit)-(*pit), krcv, ksnd));
 		}
 	    }
 	}
@@ -649,11 +909,16 @@ FabArrayBase::FB::define_fb(const FabArrayBase& fa)
 	check_local = true;
     }
 
+    for (int i = 0; i < nlocal; ++i) {
+	qbxs[i] = amrex::grow(ba[imap[i]], ng);
+    }
+    ba.intersections(qbxs, pshifts, isects, offsets);
+
     for (int i = 0; i < nlocal; ++i)
     {
 	const int   krcv = imap[i];
 	const Box& vbx   = ba[krcv];
-	const Box& bxrcv = amrex::grow(vbx, ng);
+	const Box& bxrcv = qbxs[i];
 	
 	if (check_local) {
 	    localtouch.resize(bxrcv);
@@ -665,11 +930,12 @@ FabArrayBase::FB::define_fb(const FabArrayBase& fa)
 	    remotetouch.setVal(0);
 	}
 	
-	for (auto pit=pshifts.cbegin(); pit!=pshifts.cend(); ++pit)
+	for (int ip = 0; ip < npshifts; ++ip)
 	{
-	    ba.intersections(bxrcv+(*pit), isects);
+	    const auto pit = pshifts.cbegin() + ip;
+	    const int k = i*npshifts + ip;
 
-	    for (int j = 0, M = isects.size(); j < M; ++j)
+	    for (int j = offsets[k], M = offsets[k+1]; j < M; ++j)
 	    {
 		const int ksnd      = isects[j].first;
 		const Box& dst_bx   = isects[j].second - *pit;
@@ -691,8 +957,9 @@ FabArrayBase::FB::define_fb(const FabArrayBase& fa)
 			if (check_local) {
 			    localtouch.plus(1, blbx);
 			}
-		    } else if (MyProc == dm[krcv]) {
-			recv_tags[src_owner].push_back(CopyComTag(blbx, blbx+(*pit), krcv, ksnd));
+		    } else if (MyProc == commReceiver(m_agg, src_owner, dm[krcv])) {
+			const int sndr = commSender(m_agg, src_owner, dm[krcv]);
+			recv_tags[sndr].push_back(CopyComTag(blbx, blbx+(*pit), krcv, ksnd));
 			if (check_remote) {
 			    remotetouch.plus(1, blbx);
 			}
@@ -845,10 +1112,11 @@ FabArrayBase::FB::define_epo (const FabArrayBase& fa)
 		    
 		    if (ParallelDescriptor::sameTeam(dst_owner)) {
 			continue;  // local copy will be dealt with later
-		    } else if (MyProc == dm[ksnd]) {
+		    } else if (MyProc == commSender(m_agg, dm[ksnd], dst_owner)) {
+			const int rcvr = commReceiver(m_agg, dm[ksnd], dst_owner);
 			const BoxList& bl = amrex::boxDiff(bx, pdomain);
 			for (BoxList::const_iterator lit = bl.begin(); lit != bl.end(); ++lit) {
-			    send_tags[dst_owner].push_back(CopyComTag(*lit, (*lit)-(*pit), krcv, ksnd));
+			    send_tags[rcvr].push_back(CopyComTag(*lit, (*lit)-(*pit), krcv, ksnd));
 			}
 		    }
 		}
@@ -921,8 +1189,9 @@ FabArrayBase::FB::define_epo (const FabArrayBase& fa)
 				if (check_local) {
 				    localtouch.plus(1, dbx);
 				}
-			    } else if (MyProc == dm[krcv]) {
-				recv_tags[src_owner].push_back(CopyComTag(dbx, sbx, krcv, ksnd));
+			    } else if (MyProc == commReceiver(m_agg, src_owner, dm[krcv])) {
+				const int sndr = commSender(m_agg, src_owner, dm[krcv]);
+				recv_tags[sndr].push_back(CopyComTag(dbx, sbx, krcv, ksnd));
 				if (check_remote) {
 				    remotetouch.plus(1, dbx);
 				}
@@ -978,6 +1247,17 @@ FabArrayBase::FB::define_epo (const FabArrayBase& fa)
     }
 }
 
+FabArrayBase::FB::FB ()
+    : m_ngrow(0), m_cross(false), m_epo(false), m_agg(false),
+      m_threadsafe_loc(false), m_threadsafe_rcv(false),
+      m_LocTags(new CopyComTag::CopyComTagsContainer),
+      m_SndTags(new CopyComTag::MapOfCopyComTagContainers),
+      m_RcvTags(new CopyComTag::MapOfCopyComTagContainers),
+      m_SndVols(new CopyComTag::MapOfCopyComTagContainers),
+      m_RcvVols(new CopyComTag::MapOfCopyComTagContainers),
+      m_nuse(0), m_last_use(0)
+{}
+
 FabArrayBase::FB::~FB ()
 {
     delete m_LocTags;
@@ -985,6 +1265,183 @@ FabArrayBase::FB::~FB ()
     delete m_RcvTags;
     delete m_SndVols;
     delete m_RcvVols;
+    for (auto& kv : m_persistent_plans) {
+        delete kv.second;
+    }
+    for (auto& kv : m_neighbor_plans) {
+        delete kv.second;
+    }
+}
+
+FabArrayBase::PersistentPlan::~PersistentPlan ()
+{
+#ifdef BL_USE_MPI
+    for (auto& req : m_send_reqs) {
+        if (req != MPI_REQUEST_NULL) MPI_Request_free(&req);
+    }
+    for (auto& req : m_recv_reqs) {
+        if (req != MPI_REQUEST_NULL) MPI_Request_free(&req);
+    }
+#endif
+    if (m_the_send_data) amrex::The_Arena()->free(m_the_send_data);
+    if (m_the_recv_data) amrex::The_Arena()->free(m_the_recv_data);
+}
+
+void
+FabArrayBase::PersistentPlan::define (const Vector<int>& send_rank, const Vector<int>& send_size,
+                                      const Vector<int>& recv_rank, const Vector<int>& recv_size,
+                                      int tag)
+{
+    BL_PROFILE("FabArrayBase::PersistentPlan::define()");
+
+    BL_ASSERT(send_rank.size() == send_size.size());
+    BL_ASSERT(recv_rank.size() == recv_size.size());
+
+    m_tag = tag;
+
+    // Zero-sized messages are dropped so that every request is startable.
+    for (int i = 0, N = send_rank.size(); i < N; ++i) {
+        if (send_size[i] > 0) {
+            m_send_rank.push_back(send_rank[i]);
+            m_send_size.push_back(send_size[i]);
+        }
+    }
+    for (int i = 0, N = recv_rank.size(); i < N; ++i) {
+        if (recv_size[i] > 0) {
+            m_recv_rank.push_back(recv_rank[i]);
+            m_recv_size.push_back(recv_size[i]);
+        }
+    }
+
+    const int nsend = m_send_rank.size();
+    const int nrecv = m_recv_rank.size();
+
+    std::size_t tot_send = std::accumulate(m_send_size.begin(), m_send_size.end(), std::size_t(0));
+    std::size_t tot_recv = std::accumulate(m_recv_size.begin(), m_recv_size.end(), std::size_t(0));
+
+    if (tot_send > 0) {
+        m_the_send_data = static_cast<char*>(amrex::The_Arena()->alloc(tot_send));
+    }
+    if (tot_recv > 0) {
+        m_the_recv_data = static_cast<char*>(amrex::The_Arena()->alloc(tot_recv));
+    }
+
+    m_send_data.resize(nsend, nullptr);
+    m_send_reqs.resize(nsend, MPI_REQUEST_NULL);
+    m_recv_data.resize(nrecv, nullptr);
+    m_recv_reqs.resize(nrecv, MPI_REQUEST_NULL);
+
+    std::size_t offset = 0;
+    for (int i = 0; i < nsend; ++i) {
+        m_send_data[i] = m_the_send_data + offset;
+        offset += m_send_size[i];
+#ifdef BL_USE_MPI
+        BL_MPI_REQUIRE( MPI_Send_init(m_send_data[i], m_send_size[i], MPI_CHAR, m_send_rank[i],
+                                      m_tag, FabArrayBase::persistent_comm, &m_send_reqs[i]) );
+#endif
+    }
+
+    offset = 0;
+    for (int i = 0; i < nrecv; ++i) {
+        m_recv_data[i] = m_the_recv_data + offset;
+        offset += m_recv_size[i];
+#ifdef BL_USE_MPI
+        BL_MPI_REQUIRE( MPI_Recv_init(m_recv_data[i], m_recv_size[i], MPI_CHAR, m_recv_rank[i],
+                                      m_tag, FabArrayBase::persistent_comm, &m_recv_reqs[i]) );
+#endif
+    }
+}
+
+long
+FabArrayBase::PersistentPlan::bytes () const
+{
+    return sizeof(PersistentPlan)
+        + std::accumulate(m_send_size.begin(), m_send_size.end(), 0L)
+        + std::accumulate(m_recv_size.begin(), m_recv_size.end(), 0L)
+        + (sizeof(int)*2 + sizeof(char*) + sizeof(MPI_Request)) * (m_send_rank.size() + m_recv_rank.size());
+}
+
+FabArrayBase::NeighborPlan::~NeighborPlan ()
+{
+#ifdef BL_USE_MPI3
+    if (m_req != MPI_REQUEST_NULL) MPI_Request_free(&m_req);
+#endif
+    if (m_comm != MPI_COMM_NULL) FabArrayBase::m_retired_comms.push_back(m_comm);
+    if (m_the_send_data) amrex::The_Arena()->free(m_the_send_data);
+    if (m_the_recv_data) amrex::The_Arena()->free(m_the_recv_data);
+}
+
+void
+FabArrayBase::NeighborPlan::define (const Vector<int>& send_rank, const Vector<int>& send_size,
+                                    const Vector<int>& recv_rank, const Vector<int>& recv_size)
+{
+    BL_PROFILE("FabArrayBase::NeighborPlan::define()");
+
+    BL_ASSERT(send_rank.size() == send_size.size());
+    BL_ASSERT(recv_rank.size() == recv_size.size());
+
+    // Zero-sized messages are dropped on both sides, so the graph stays symmetric.
+    for (int i = 0, N = send_rank.size(); i < N; ++i) {
+        if (send_size[i] > 0) {
+            m_send_rank.push_back(send_rank[i]);
+            m_send_size.push_back(send_size[i]);
+        }
+    }
+    for (int i = 0, N = recv_rank.size(); i < N; ++i) {
+        if (recv_size[i] > 0) {
+            m_recv_rank.push_back(recv_rank[i]);
+            m_recv_size.push_back(recv_size[i]);
+        }
+    }
+
+    const int nsend = m_send_rank.size();
+    const int nrecv = m_recv_rank.size();
+
+    m_send_disp.resize(nsend, 0);
+    m_recv_disp.resize(nrecv, 0);
+    for (int i = 1; i < nsend; ++i) {
+        m_send_disp[i] = m_send_disp[i-1] + m_send_size[i-1];
+    }
+    for (int i = 1; i < nrecv; ++i) {
+        m_recv_disp[i] = m_recv_disp[i-1] + m_recv_size[i-1];
+    }
+
+    const long tot_send = std::accumulate(m_send_size.begin(), m_send_size.end(), 0L);
+    const long tot_recv = std::accumulate(m_recv_size.begin(), m_recv_size.end(), 0L);
+    BL_ASSERT(tot_send < std::numeric_limits<int>::max());
+    BL_ASSERT(tot_recv < std::numeric_limits<int>::max());
+
+    if (tot_send > 0) {
+        m_the_send_data = static_cast<char*>(amrex::The_Arena()->alloc(tot_send));
+    }
+    if (tot_recv > 0) {
+        m_the_recv_data = static_cast<char*>(amrex::The_Arena()->alloc(tot_recv));
+    }
+
+    m_send_data.resize(nsend);
+    m_recv_data.resize(nrecv);
+    for (int i = 0; i < nsend; ++i) {
+        m_send_data[i] = m_the_send_data + m_send_disp[i];
+    }
+    for (int i = 0; i < nrecv; ++i) {
+        m_recv_data[i] = m_the_recv_data + m_recv_disp[i];
+    }
+
+#ifdef BL_USE_MPI3
+    BL_MPI_REQUIRE( MPI_Dist_graph_create_adjacent(ParallelDescriptor::Communicator(),
+                                                   nrecv, m_recv_rank.dataPtr(), MPI_UNWEIGHTED,
+                                                   nsend, m_send_rank.dataPtr(), MPI_UNWEIGHTED,
+                                                   MPI_INFO_NULL, 0, &m_comm) );
+#endif
+}
+
+long
+FabArrayBase::NeighborPlan::bytes () const
+{
+    return sizeof(NeighborPlan)
+        + std::accumulate(m_send_size.begin(), m_send_size.end(), 0L)
+        + std::accumulate(m_recv_size.begin(), m_recv_size.end(), 0L)
+        + (sizeof(int)*3 + sizeof(char*)) * (m_send_rank.size() + m_recv_rank.size());
 }
 
 void
@@ -994,9 +1451,7 @@ FabArrayBase::flushFB (bool no_assertion) const
     std::pair<FBCacheIter,FBCacheIter> er_it = m_TheFBCache.equal_range(m_bdkey);
     for (FBCacheIter it = er_it.first; it != er_it.second; ++it)
     {
-#ifdef BL_MEM_PROFILING
 	m_FBC_stats.bytes -= it->second->bytes();
-#endif
 	m_FBC_stats.recordErase(it->second->m_nuse);
 	delete it->second;
     }
@@ -1012,9 +1467,7 @@ FabArrayBase::flushFBCache ()
 	delete it->second;
     }
     m_TheFBCache.clear();
-#ifdef BL_MEM_PROFILING
     m_FBC_stats.bytes = 0L;
-#endif
 }
 
 const FabArrayBase::FB&
@@ -1023,6 +1476,7 @@ FabArrayBase::getFB (const Periodicity& period, bool cross, bool enforce_periodi
     BL_PROFILE("FabArrayBase::getFB()");
 
     BL_ASSERT(getBDKey() == m_bdkey);
+    const bool agg = aggregateTeams(boxArray().ixType());
     std::pair<FBCacheIter,FBCacheIter> er_it = m_TheFBCache.equal_range(m_bdkey);
     for (FBCacheIter it = er_it.first; it != er_it.second; ++it)
     {
@@ -1031,28 +1485,65 @@ FabArrayBase::getFB (const Periodicity& period, bool cross, bool enforce_periodi
 	    it->second->m_ngrow      == nGrow()                  &&
 	    it->second->m_cross      == cross                    &&
 	    it->second->m_epo        == enforce_periodicity_only &&
+	    it->second->m_agg        == agg                      &&
 	    it->second->m_period     == period              )
 	{
 	    ++(it->second->m_nuse);
+	    it->second->m_last_use = ++m_cache_tick;
 	    m_FBC_stats.recordUse();
 	    return *(it->second);
 	}
     }
 
-    // Have to build a new one
-    FB* new_fb = new FB(*this, cross, period, enforce_periodicity_only);
+    // Have to build a new one, unless readCommMetaData has it
+    FB* new_fb = nullptr;
 
-#ifdef BL_PROFILE
-    m_FBC_stats.bytes += new_fb->bytes();
-    m_FBC_stats.bytes_hwm = std::max(m_FBC_stats.bytes_hwm, m_FBC_stats.bytes);
-#endif
+    if ( ! m_LoadedFB.empty())
+    {
+	const BDHash h = hashBD(boxArray(), DistributionMap());
+	if (matchLoadedBD(h, boxArray(), DistributionMap()))
+	{
+	    auto range = m_LoadedFB.equal_range(h);
+	    for (auto it = range.first; it != range.second; ++it)
+	    {
+		FB* fb = it->second;
+		if (fb->m_ngrow  == nGrow()                  &&
+		    fb->m_cross  == cross                    &&
+		    fb->m_epo    == enforce_periodicity_only &&
+		    fb->m_period == period)
+		{
+		    fb->m_typ        = boxArray().ixType();
+		    fb->m_crse_ratio = boxArray().crseRatio();
+		    fb->m_ba         = boxArray();
+		    fb->m_dm         = DistributionMap();
+		    fb->m_agg        = agg;  // FabArrayBase::use_node_aggregation is in the settings
+		    new_fb = fb;
+		    m_LoadedFB.erase(it);
+		    releaseLoadedBD(h);
+		    m_FBC_stats.recordLoad();
+		    break;
+		}
+	    }
+	}
+    }
+
+    if (new_fb == nullptr) {
+	new_fb = new FB(*this, cross, period, enforce_periodicity_only);
+	m_FBC_stats.recordBuild();
+    }
+
+    m_FBC_stats.recordBytes(new_fb->bytes());
 
     new_fb->m_nuse = 1;
-    m_FBC_stats.recordBuild();
+    new_fb->m_last_use = ++m_cache_tick;
     m_FBC_stats.recordUse();
 
     m_TheFBCache.insert(er_it.second, FBCache::value_type(m_bdkey,new_fb));
 
+    if (cache_max_bytes > 0 && cacheBytes() > cache_max_bytes) {
+        evictCaches(cache_max_bytes, FBKind, new_fb);
+    }
+
     return *new_fb;
 }
 
@@ -1067,7 +1558,13 @@ FabArrayBase::FPinfo::FPinfo (const FabArrayBase& srcfa,
       m_dstdomain(dstdomain),
       m_dstng    (dstng),
       m_coarsener(coarsener.clone()),
-      m_nuse     (0)
+      m_crse_dstdomain(coarsener.doit(dstdomain)),
+      m_srcba    (srcfa.boxArray()),
+      m_srcdm    (srcfa.DistributionMap()),
+      m_dstba    (dstfa.boxArray()),
+      m_dstdm    (dstfa.DistributionMap()),
+      m_nuse     (0),
+      m_last_use (0)
 { 
     BL_PROFILE("FPinfo::FPinfo()");
 
@@ -1110,17 +1607,14 @@ FabArrayBase::FPinfo::FPinfo (const FabArrayBase& srcfa,
     if (!iprocs.empty()) {
 	ba_crse_patch.define(bl);
 	dm_crse_patch.define(iprocs);
-#ifdef AMREX_USE_EB
-        fact_crse_patch.reset(new EBFArrayBoxFactory(Geometry(cdomain),
-                                                     ba_crse_patch,
-                                                     dm_crse_patch,
-                                                     {0,0,0}, EBSupport::basic));
-#else
-        fact_crse_patch.reset(new FArrayBoxFactory());
-#endif
+        fact_crse_patch.reset(makeCrsePatchFactory(ba_crse_patch, dm_crse_patch, cdomain));
     }
 }
 
+FabArrayBase::FPinfo::FPinfo ()
+    : m_dstng(0), m_coarsener(nullptr), m_nuse(0), m_last_use(0)
+{}
+
 FabArrayBase::FPinfo::~FPinfo ()
 {
     delete m_coarsener;
@@ -1160,21 +1654,62 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
 	    it->second->m_coarsener->doit(it->second->m_dstdomain) == coarsener.doit(dstdomain))
 	{
 	    ++(it->second->m_nuse);
+	    it->second->m_last_use = ++m_cache_tick;
 	    m_FPinfo_stats.recordUse();
 	    return *(it->second);
 	}
     }
 
-    // Have to build a new one
-    FPinfo* new_fpc = new FPinfo(srcfa, dstfa, dstdomain, dstng, coarsener, cdomain);
+    // Have to build a new one, unless readCommMetaData has it
+    FPinfo* new_fpc = nullptr;
 
-#ifdef BL_MEM_PROFILING
-    m_FPinfo_stats.bytes += new_fpc->bytes();
-    m_FPinfo_stats.bytes_hwm = std::max(m_FPinfo_stats.bytes_hwm, m_FPinfo_stats.bytes);
-#endif
+    if ( ! m_LoadedFPinfo.empty())
+    {
+	const BDHash dsth = hashBD(dstfa.boxArray(), dstfa.DistributionMap());
+	const BDHash srch = hashBD(srcfa.boxArray(), srcfa.DistributionMap());
+	if (matchLoadedBD(dsth, dstfa.boxArray(), dstfa.DistributionMap()) &&
+	    matchLoadedBD(srch, srcfa.boxArray(), srcfa.DistributionMap()))
+	{
+	    auto range = m_LoadedFPinfo.equal_range(std::make_pair(dsth,srch));
+	    for (auto it = range.first; it != range.second; ++it)
+	    {
+		FPinfo* fpc = it->second;
+		if (fpc->m_dstdomain == dstdomain &&
+		    fpc->m_dstng     == dstng     &&
+		    fpc->m_dstdomain.ixType() == dstdomain.ixType() &&
+		    fpc->m_crse_dstdomain == coarsener.doit(dstdomain))
+		{
+		    fpc->m_srcbdk    = srckey;
+		    fpc->m_dstbdk    = dstkey;
+		    fpc->m_coarsener = coarsener.clone();
+		    fpc->m_srcba     = srcfa.boxArray();
+		    fpc->m_srcdm     = srcfa.DistributionMap();
+		    fpc->m_dstba     = dstfa.boxArray();
+		    fpc->m_dstdm     = dstfa.DistributionMap();
+		    if (!fpc->ba_crse_patch.empty()) {
+			fpc->fact_crse_patch.reset(makeCrsePatchFactory(fpc->ba_crse_patch,
+									fpc->dm_crse_patch, cdomain));
+		    }
+		    new_fpc = fpc;
+		    m_LoadedFPinfo.erase(it);
+		    releaseLoadedBD(dsth);
+		    releaseLoadedBD(srch);
+		    m_FPinfo_stats.recordLoad();
+		    break;
+		}
+	    }
+	}
+    }
+
+    if (new_fpc == nullptr) {
+	new_fpc = new FPinfo(srcfa, dstfa, dstdomain, dstng, coarsener, cdomain);
+	m_FPinfo_stats.recordBuild();
+    }
+
+    m_FPinfo_stats.recordBytes(new_fpc->bytes());
     
     new_fpc->m_nuse = 1;
-    m_FPinfo_stats.recordBuild();
+    new_fpc->m_last_use = ++m_cache_tick;
     m_FPinfo_stats.recordUse();
 
     m_TheFillPatchCache.insert(er_it.second, FPinfoCache::value_type(dstkey,new_fpc));
@@ -1212,9 +1747,7 @@ FabArrayBase::flushFPinfo (bool no_assertion)
 	    }
 	} 
 
-#ifdef BL_MEM_PROFILING
 	m_FPinfo_stats.bytes -= it->second->bytes();
-#endif
 	m_FPinfo_stats.recordErase(it->second->m_nuse);
 	delete it->second;
     }
@@ -1237,7 +1770,8 @@ FabArrayBase::CFinfo::CFinfo (const FabArrayBase& finefa,
       m_ng       (ng),
       m_include_periodic(include_periodic),
       m_include_physbndry(include_physbndry),
-      m_nuse     (0)
+      m_nuse     (0),
+      m_last_use (0)
 {
     BL_PROFILE("CFinfo::CFinfo()");
     
@@ -1321,6 +1855,7 @@ FabArrayBase::TheCFinfo (const FabArrayBase& finefa,
             it->second->m_ng          == ng)
         {
             ++(it->second->m_nuse);
+            it->second->m_last_use = ++m_cache_tick;
             m_CFinfo_stats.recordUse();
             return *(it->second);
         }
@@ -1329,17 +1864,19 @@ FabArrayBase::TheCFinfo (const FabArrayBase& finefa,
     // Have to build a new one
     CFinfo* new_cfinfo = new CFinfo(finefa, finegm, ng, include_periodic, include_physbndry);
 
-#ifdef BL_MEM_PROFILING
-    m_CFinfo_stats.bytes += new_cfinfo->bytes();
-    m_CFinfo_stats.bytes_hwm = std::max(m_CFinfo_stats.bytes_hwm, m_CFinfo_stats.bytes);
-#endif
+    m_CFinfo_stats.recordBytes(new_cfinfo->bytes());
 
     new_cfinfo->m_nuse = 1;
+    new_cfinfo->m_last_use = ++m_cache_tick;
     m_CFinfo_stats.recordBuild();
     m_CFinfo_stats.recordUse();
 
     m_TheCrseFineCache.insert(er_it.second, CFinfoCache::value_type(key,new_cfinfo));
 
+    if (cache_max_bytes > 0 && cacheBytes() > cache_max_bytes) {
+        evictCaches(cache_max_bytes, CFinfoKind, new_cfinfo);
+    }
+
     return *new_cfinfo;
 }
 
@@ -1350,9 +1887,7 @@ FabArrayBase::flushCFinfo (bool no_assertion)
     auto er_it = m_TheCrseFineCache.equal_range(m_bdkey);
     for (auto it = er_it.first; it != er_it.second; ++it)
     {
-#ifdef BL_MEM_PROFILING
         m_CFinfo_stats.bytes -= it->second->bytes();
-#endif
         m_CFinfo_stats.recordErase(it->second->m_nuse);
         delete it->second;
     }
@@ -1367,6 +1902,18 @@ FabArrayBase::Finalize ()
 
     FabArrayBase::flushTileArrayCache();
 
+    FabArrayBase::clearCommMetaData();
+
+    FabArrayBase::freeNeighborComms();
+
+    The_Arena()->release();
+
+#ifdef BL_USE_MPI
+    if (FabArrayBase::persistent_comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&FabArrayBase::persistent_comm);
+    }
+#endif
+
     if (ParallelDescriptor::IOProcessor() && amrex::system::verbose) {
 	m_FA_stats.print();
 	m_TAC_stats.print();
@@ -1396,12 +1943,9 @@ FabArrayBase::getTileArray (const IntVect& tilesize) const
 	    buildTileArray(tilesize, *p);
 	    p->nuse = 0;
 	    m_TAC_stats.recordBuild();
-#ifdef BL_MEM_PROFILING
-	    m_TAC_stats.bytes += p->bytes();
-	    m_TAC_stats.bytes_hwm = std::max(m_TAC_stats.bytes_hwm,
-					     m_TAC_stats.bytes);
-#endif
+	    m_TAC_stats.recordBytes(p->bytes());
 	}
+	p->last_use = ++m_cache_tick;
 #ifdef _OPENMP
 #pragma omp master
 #endif
@@ -1521,9 +2065,7 @@ FabArrayBase::flushTileArray (const IntVect& tileSize, bool no_assertion) const
 	    for (TAMap::const_iterator tai_it = tao_it->second.begin();
 		 tai_it != tao_it->second.end(); ++tai_it)
 	    {
-#ifdef BL_MEM_PROFILING
 		m_TAC_stats.bytes -= tai_it->second.bytes();
-#endif		
 		m_TAC_stats.recordErase(tai_it->second.nuse);
 	    }
 	    tao.erase(tao_it);
@@ -1534,9 +2076,7 @@ FabArrayBase::flushTileArray (const IntVect& tileSize, bool no_assertion) const
             const IntVect& crse_ratio = boxArray().crseRatio();
 	    TAMap::iterator tai_it = tai.find(std::pair<IntVect,IntVect>(tileSize,crse_ratio));
 	    if (tai_it != tai.end()) {
-#ifdef BL_MEM_PROFILING
 		m_TAC_stats.bytes -= tai_it->second.bytes();
-#endif		
 		m_TAC_stats.recordErase(tai_it->second.nuse);
 		tai.erase(tai_it);
 	    }
@@ -1557,9 +2097,714 @@ FabArrayBase::flushTileArrayCache ()
 	}
     }
     m_TheTileArrayCache.clear();
-#ifdef BL_MEM_PROFILING
     m_TAC_stats.bytes = 0L;
+}
+
+long
+FabArrayBase::cacheBytes ()
+{
+    return m_TAC_stats.bytes + m_FBC_stats.bytes + m_CPC_stats.bytes
+        + m_FPinfo_stats.bytes + m_CFinfo_stats.bytes;
+}
+
+Vector<FabArrayBase::CacheStats>
+FabArrayBase::cacheStats ()
+{
+    return {m_TAC_stats, m_FBC_stats, m_CPC_stats, m_FPinfo_stats, m_CFinfo_stats};
+}
+
+void
+FabArrayBase::writeCacheStatsJSON (std::ostream& os)
+{
+    const Vector<CacheStats>& stats = cacheStats();
+    os << "{\n"
+       << "  \"cache_max_bytes\": " << cache_max_bytes << ",\n"
+       << "  \"total_bytes\": " << cacheBytes() << ",\n"
+       << "  \"caches\": [\n";
+    for (int i = 0, N = stats.size(); i < N; ++i)
+    {
+        const CacheStats& st = stats[i];
+        os << "    {\"name\": \"" << st.name << "\""
+           << ", \"size\": "      << st.size
+           << ", \"max_size\": "  << st.maxsize
+           << ", \"uses\": "      << st.nuse
+           << ", \"builds\": "    << st.nbuild
+           << ", \"loads\": "     << st.nload
+           << ", \"hit_rate\": "  << st.hitRate()
+           << ", \"erasures\": "  << st.nerase
+           << ", \"evictions\": " << st.nevict
+           << ", \"bytes\": "     << st.bytes
+           << ", \"bytes_hwm\": " << st.bytes_hwm
+           << ((i < N-1) ? "},\n" : "}\n");
+    }
+    os << "  ]\n}\n";
+}
+
+void
+FabArrayBase::freeNeighborComms ()
+{
+#ifdef BL_USE_MPI3
+    for (auto& comm : m_retired_comms) {
+        BL_MPI_REQUIRE( MPI_Comm_free(&comm) );
+    }
+#endif
+    m_retired_comms.clear();
+}
+
+namespace {
+    // Remove the entry of cache under key that points to p.
+    template <class C, class K, class T>
+    void eraseCacheEntry (C& cache, const K& key, const T* p)
+    {
+        auto er_it = cache.equal_range(key);
+        for (auto it = er_it.first; it != er_it.second; ++it) {
+            if (it->second == p) {
+                cache.erase(it);
+                return;
+            }
+        }
+    }
+}
+
+void
+FabArrayBase::evictCaches (long max_bytes, int kinds, const void* keep)
+{
+    long total = cacheBytes();
+    if (total <= max_bytes) return;
+
+    BL_PROFILE("FabArrayBase::evictCaches()");
+
+    //
+    // The candidates for eviction, with the time of their last use.  The
+    // function erases the item and returns the number of bytes freed.
+    //
+    std::vector<std::pair<long, std::function<long()> > > items;
+
+    if (kinds & TileArrayKind)
+    {
+        for (auto const& kv : m_TheTileArrayCache)
+        {
+            for (auto const& tkv : kv.second)
+            {
+                const BDKey key  = kv.first;
+                const auto  tkey = tkv.first;
+                items.emplace_back(tkv.second.last_use, [key,tkey] () -> long {
+                    TAMap& tai = m_TheTileArrayCache[key];
+                    auto it = tai.find(tkey);
+                    const long b = it->second.bytes();
+                    m_TAC_stats.bytes -= b;
+                    m_TAC_stats.recordErase(it->second.nuse);
+                    ++m_TAC_stats.nevict;
+                    tai.erase(it);
+                    if (tai.empty()) m_TheTileArrayCache.erase(key);
+                    return b;
+                });
+            }
+        }
+    }
+
+    //
+    // Is a persistent plan of fb between its nowait and its finish?
+    //
+    auto in_flight = [] (const FB* fb) -> bool
+    {
+        for (auto const& pkv : fb->m_persistent_plans) {
+            if (pkv.second->m_in_flight) return true;
+        }
+        return false;
+    };
+
+    if (kinds & FBKind)
+    {
+        for (auto const& kv : m_TheFBCache)
+        {
+            FB* fb = kv.second;
+            if (fb != keep && fb->m_neighbor_plans.empty() && !in_flight(fb))
+            {
+                const BDKey key = kv.first;
+                items.emplace_back(fb->m_last_use, [key,fb] () -> long {
+                    const long b = fb->bytes();
+                    m_FBC_stats.bytes -= b;
+                    m_FBC_stats.recordErase(fb->m_nuse);
+                    ++m_FBC_stats.nevict;
+                    eraseCacheEntry(m_TheFBCache, key, fb);
+                    delete fb;
+                    return b;
+                });
+            }
+        }
+    }
+
+    if (kinds & CPCKind)
+    {
+        for (auto const& kv : m_TheCPCache)
+        {
+            CPC* cpc = kv.second;
+            // CPCs are in the cache under both src and dst keys.
+            if (kv.first == cpc->m_dstbdk && cpc != keep && cpc->m_npending == 0)
+            {
+                items.emplace_back(cpc->m_last_use, [cpc] () -> long {
+                    const long b = cpc->bytes();
+                    m_CPC_stats.bytes -= b;
+                    m_CPC_stats.recordErase(cpc->m_nuse);
+                    ++m_CPC_stats.nevict;
+                    eraseCacheEntry(m_TheCPCache, cpc->m_dstbdk, cpc);
+                    if (cpc->m_srcbdk != cpc->m_dstbdk)
+                        eraseCacheEntry(m_TheCPCache, cpc->m_srcbdk, cpc);
+                    delete cpc;
+                    return b;
+                });
+            }
+        }
+    }
+
+    if (kinds & FPinfoKind)
+    {
+        for (auto const& kv : m_TheFillPatchCache)
+        {
+            FPinfo* fpc = kv.second;
+            if (kv.first == fpc->m_dstbdk && fpc != keep) // Also under both src and dst keys.
+            {
+                items.emplace_back(fpc->m_last_use, [fpc] () -> long {
+                    const long b = fpc->bytes();
+                    m_FPinfo_stats.bytes -= b;
+                    m_FPinfo_stats.recordErase(fpc->m_nuse);
+                    ++m_FPinfo_stats.nevict;
+                    eraseCacheEntry(m_TheFillPatchCache, fpc->m_dstbdk, fpc);
+                    if (fpc->m_srcbdk != fpc->m_dstbdk)
+                        eraseCacheEntry(m_TheFillPatchCache, fpc->m_srcbdk, fpc);
+                    delete fpc;
+                    return b;
+                });
+            }
+        }
+    }
+
+    if (kinds & CFinfoKind)
+    {
+        for (auto const& kv : m_TheCrseFineCache)
+        {
+            CFinfo* cfi = kv.second;
+            if (cfi == keep) continue;
+            items.emplace_back(cfi->m_last_use, [cfi] () -> long {
+                const long b = cfi->bytes();
+                m_CFinfo_stats.bytes -= b;
+                m_CFinfo_stats.recordErase(cfi->m_nuse);
+                ++m_CFinfo_stats.nevict;
+                eraseCacheEntry(m_TheCrseFineCache, cfi->m_fine_bdk, cfi);
+                delete cfi;
+                return b;
+            });
+        }
+    }
+
+    std::sort(items.begin(), items.end(),
+              [] (const std::pair<long, std::function<long()> >& a,
+                  const std::pair<long, std::function<long()> >& b)
+              { return a.first < b.first; });
+
+    for (int i = 0, N = items.size(); i < N && total > max_bytes; ++i)
+    {
+        total -= items[i].second();
+    }
+}
+
+void
+FabArrayBase::trimCaches (long max_bytes)
+{
+    if (max_bytes <= 0) return;
+
+    BL_PROFILE("FabArrayBase::trimCaches()");
+
+    evictCaches(max_bytes, AllKinds, nullptr);
+
+#ifdef BL_USE_MPI3
+    //
+    // Neighbor collective plans are rebuilt collectively, so their FB
+    // items go on all processes or on none.
+    //
+    if (use_neighbor_collectives)
+    {
+        bool over = cacheBytes() > max_bytes;
+        ParallelDescriptor::ReduceBoolOr(over);
+        if (over)
+        {
+            for (auto it = m_TheFBCache.begin(); it != m_TheFBCache.end(); )
+            {
+                FB* fb = it->second;
+                if ( ! fb->m_neighbor_plans.empty())
+                {
+                    m_FBC_stats.bytes -= fb->bytes();
+                    m_FBC_stats.recordErase(fb->m_nuse);
+                    ++m_FBC_stats.nevict;
+                    delete fb;
+                    it = m_TheFBCache.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+    }
+#endif
+}
+
+namespace {
+    const std::string CommMetaDataVersion("CommMetaData_V1");
+
+    // Starts the data of each process in the Data_* files.
+    const std::uint32_t CommMetaDataMagic = 0x434d4431;
+
+    // The order in memory of the bytes of a 32-bit integer, i.e., 1234 on
+    // little endian machines and 4321 on big endian ones.
+    int byteOrder ()
+    {
+        const std::uint32_t v = 0x04030201;
+        unsigned char b[sizeof(v)];
+        std::memcpy(b, &v, sizeof(v));
+        return 1000*b[0] + 100*b[1] + 10*b[2] + b[3];
+    }
+
+    // Raw binary I/O of the tags.  Metadata are only read back on the same
+    // kind of machine, which readCommMetaData checks with byteOrder() and
+    // sizeof(CopyComTag).
+    template <class T>
+    void writePOD (std::ostream& os, const T& v)
+    {
+        os.write(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+
+    template <class T>
+    void readPOD (std::istream& is, T& v)
+    {
+        is.read(reinterpret_cast<char*>(&v), sizeof(T));
+    }
+
+    template <class T>
+    void writePODs (std::ostream& os, const std::vector<T>& v)
+    {
+        const long n = v.size();
+        writePOD(os, n);
+        if (n > 0) os.write(reinterpret_cast<const char*>(v.data()), n*sizeof(T));
+    }
+
+    template <class T>
+    void readPODs (std::istream& is, std::vector<T>& v)
+    {
+        long n;
+        readPOD(is, n);
+        v.resize(n);
+        if (n > 0) is.read(reinterpret_cast<char*>(v.data()), n*sizeof(T));
+    }
+
+    void writeTags (std::ostream& os, const FabArrayBase::MapOfCopyComTagContainers& m)
+    {
+        const long n = m.size();
+        writePOD(os, n);
+        for (auto const& kv : m) {
+            writePOD(os, kv.first);
+            writePODs(os, kv.second);
+        }
+    }
+
+    void readTags (std::istream& is, FabArrayBase::MapOfCopyComTagContainers& m)
+    {
+        long n;
+        readPOD(is, n);
+        for (long i = 0; i < n; ++i) {
+            int key;
+            readPOD(is, key);
+            readPODs(is, m[key]);
+        }
+    }
+
+    // The settings the tags depend on besides the BoxArrays and DistributionMappings.
+    void writeCommSettings (std::ostream& os)
+    {
+#ifdef _OPENMP
+        const int threaded = omp_get_max_threads() > 1;
+#else
+        const int threaded = 0;
 #endif
+        os << ParallelDescriptor::NProcs() << ' '
+           << ParallelDescriptor::TeamSize() << ' '
+           << FabArrayBase::use_node_aggregation << ' '
+           << threaded << ' '
+           << byteOrder() << ' '
+           << sizeof(FabArrayBase::CopyComTag) << ' '
+           << FabArrayBase::comm_tile_size << '\n';
+    }
+}
+
+void
+FabArrayBase::writeCommMetaData (const std::string& dir, int nfiles)
+{
+    BL_PROFILE("FabArrayBase::writeCommMetaData()");
+
+    if (nfiles <= 0) nfiles = VisMF::GetNOutFiles();
+
+    if (ParallelDescriptor::IOProcessor()) {
+        if ( ! amrex::UtilCreateDirectory(dir, 0755)) {
+            amrex::CreateDirectoryFailed(dir);
+        }
+    }
+    ParallelDescriptor::Barrier("FabArrayBase::writeCommMetaData");
+
+    //
+    // The BoxArrays and DistributionMappings used by the items of this
+    // process.  Those of the IOProcessor go into the Header.  The items
+    // refer to them by hash.
+    //
+    std::map<unsigned long long, std::pair<BoxArray,DistributionMapping> > bds;
+    auto addBD = [&bds] (const BoxArray& ba, const DistributionMapping& dm) -> unsigned long long
+    {
+        const unsigned long long h = hashBD(ba, dm);
+        bds.insert(std::make_pair(h, std::make_pair(ba, dm)));
+        return h;
+    };
+
+    std::vector<const FB*> fbs;
+    std::vector<unsigned long long> fb_hash;
+    for (auto const& kv : m_TheFBCache) {
+        const FB* fb = kv.second;
+        fbs.push_back(fb);
+        fb_hash.push_back(addBD(fb->m_ba, fb->m_dm));
+    }
+
+    std::vector<const CPC*> cpcs;
+    std::vector<unsigned long long> cpc_hash;
+    for (auto const& kv : m_TheCPCache) {
+        const CPC* cpc = kv.second;
+        if (kv.first == cpc->m_dstbdk) { // CPCs are in the cache under both src and dst keys.
+            cpcs.push_back(cpc);
+            cpc_hash.push_back(addBD(cpc->m_dstba, cpc->m_dstdm));
+            cpc_hash.push_back(addBD(cpc->m_srcba, cpc->m_srcdm));
+        }
+    }
+
+    std::vector<const FPinfo*> fpcs;
+    std::vector<unsigned long long> fpc_hash;
+    for (auto const& kv : m_TheFillPatchCache) {
+        const FPinfo* fpc = kv.second;
+        if (kv.first == fpc->m_dstbdk) { // Also under both src and dst keys.
+            fpcs.push_back(fpc);
+            fpc_hash.push_back(addBD(fpc->m_dstba, fpc->m_dstdm));
+            fpc_hash.push_back(addBD(fpc->m_srcba, fpc->m_srcdm));
+            fpc_hash.push_back(fpc->ba_crse_patch.empty()
+                               ? 0ULL : addBD(fpc->ba_crse_patch, fpc->dm_crse_patch));
+        }
+    }
+
+    const std::string filePrefix(dir + "/Data_");
+    long offset  = 0;
+    int  filenum = 0;
+
+    for (NFilesIter nfi(nfiles, filePrefix, false, true); nfi.ReadyToWrite(); ++nfi)
+    {
+        std::ostream& os = nfi.Stream();
+        os.seekp(0, std::ios::end);
+        offset  = nfi.SeekPos();
+        filenum = nfi.FileNumber();
+
+        writePOD(os, CommMetaDataMagic);
+        writePOD(os, long(fbs.size()));
+        for (int i = 0, N = fbs.size(); i < N; ++i)
+        {
+            const FB& fb = *fbs[i];
+            writePOD(os, fb_hash[i]);
+            writePOD(os, fb.m_ngrow);
+            writePOD(os, int(fb.m_cross));
+            writePOD(os, int(fb.m_epo));
+            writePOD(os, fb.m_period.intVect());
+            writePOD(os, int(fb.m_threadsafe_loc));
+            writePOD(os, int(fb.m_threadsafe_rcv));
+            writePODs(os, *fb.m_LocTags);
+            writeTags(os, *fb.m_SndTags);
+            writeTags(os, *fb.m_RcvTags);
+            writeTags(os, *fb.m_SndVols);
+            writeTags(os, *fb.m_RcvVols);
+        }
+
+        writePOD(os, long(cpcs.size()));
+        for (int i = 0, N = cpcs.size(); i < N; ++i)
+        {
+            const CPC& cpc = *cpcs[i];
+            writePOD(os, cpc_hash[2*i]);
+            writePOD(os, cpc_hash[2*i+1]);
+            writePOD(os, cpc.m_dstng);
+            writePOD(os, cpc.m_srcng);
+            writePOD(os, cpc.m_period.intVect());
+            writePOD(os, int(cpc.m_threadsafe_loc));
+            writePOD(os, int(cpc.m_threadsafe_rcv));
+            writePODs(os, *cpc.m_LocTags);
+            writeTags(os, *cpc.m_SndTags);
+            writeTags(os, *cpc.m_RcvTags);
+            writeTags(os, *cpc.m_SndVols);
+            writeTags(os, *cpc.m_RcvVols);
+        }
+
+        writePOD(os, long(fpcs.size()));
+        for (int i = 0, N = fpcs.size(); i < N; ++i)
+        {
+            const FPinfo& fpc = *fpcs[i];
+            writePOD(os, fpc_hash[3*i]);
+            writePOD(os, fpc_hash[3*i+1]);
+            writePOD(os, fpc_hash[3*i+2]);
+            writePOD(os, fpc.m_dstdomain);
+            writePOD(os, fpc.m_dstng);
+            writePOD(os, fpc.m_crse_dstdomain);
+            writePODs(os, fpc.dst_idxs);
+            writePODs(os, fpc.dst_boxes);
+        }
+
+        if ( ! os.good()) {
+            amrex::FileOpenFailed(nfi.FileName());
+        }
+    }
+
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+    const std::vector<long> offsets  = ParallelDescriptor::Gather(offset, ioproc);
+    const std::vector<int>  filenums = ParallelDescriptor::Gather(filenum, ioproc);
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        const std::string HeaderFileName(dir + "/Header");
+        std::ofstream HeaderFile(HeaderFileName.c_str(), std::ios::out | std::ios::trunc);
+        if ( ! HeaderFile.good()) {
+            amrex::FileOpenFailed(HeaderFileName);
+        }
+
+        HeaderFile << CommMetaDataVersion << '\n';
+        writeCommSettings(HeaderFile);
+
+        HeaderFile << bds.size() << '\n';
+        for (auto const& kv : bds)
+        {
+            HeaderFile << kv.first << '\n';
+            kv.second.first.writeOn(HeaderFile);
+            const Vector<int>& pmap = kv.second.second.ProcessorMap();
+            HeaderFile << '\n' << pmap.size() << '\n';
+            for (int p : pmap) {
+                HeaderFile << p << ' ';
+            }
+            HeaderFile << '\n';
+        }
+
+        for (int i = 0, N = offsets.size(); i < N; ++i) {
+            HeaderFile << NFilesIter::FileName(filenums[i], "Data_") << ' ' << offsets[i] << '\n';
+        }
+
+        if ( ! HeaderFile.good()) {
+            amrex::Error("FabArrayBase::writeCommMetaData() failed");
+        }
+    }
+}
+
+void
+FabArrayBase::readCommMetaData (const std::string& dir)
+{
+    BL_PROFILE("FabArrayBase::readCommMetaData()");
+
+    clearCommMetaData();
+
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(dir + "/Header", fileCharPtr, false);
+    if (fileCharPtr.empty()) {
+        return;
+    }
+
+    std::istringstream is(std::string(fileCharPtr.dataPtr()), std::istringstream::in);
+
+    std::string version, settings, cur_settings;
+    std::getline(is, version);
+    std::getline(is, settings);
+    {
+        std::ostringstream os;
+        writeCommSettings(os);
+        cur_settings = os.str();
+        cur_settings.pop_back();
+    }
+
+    if (version != CommMetaDataVersion || settings != cur_settings) {
+        amrex::Print() << "FabArrayBase::readCommMetaData: " << dir
+                       << " does not match this run; ignored\n";
+        return;
+    }
+
+    long nbds;
+    is >> nbds;
+    for (long i = 0; i < nbds; ++i)
+    {
+        BDHash h;
+        is >> h;
+        BoxArray ba;
+        ba.readFrom(is);
+        int n;
+        is >> n;
+        Vector<int> pmap(n);
+        for (int& p : pmap) {
+            is >> p;
+        }
+        m_LoadedBD[h] = LoadedBD{ba, DistributionMapping(pmap), 0};
+    }
+
+    std::string fileName;
+    long offset = -1;
+    for (int i = 0; i <= ParallelDescriptor::MyProc(); ++i) {
+        is >> fileName >> offset;
+    }
+
+    if ( ! is.good()) {
+        amrex::Error("FabArrayBase::readCommMetaData: failed to read " + dir + "/Header");
+    }
+
+    const std::string FullName(dir + "/" + fileName);
+    std::ifstream ifs(FullName.c_str(), std::ios::in | std::ios::binary);
+    if ( ! ifs.good()) {
+        amrex::FileOpenFailed(FullName);
+    }
+    ifs.seekg(offset, std::ios::beg);
+
+    std::uint32_t magic = 0;
+    readPOD(ifs, magic);
+    if (magic != CommMetaDataMagic) {
+        amrex::Error("FabArrayBase::readCommMetaData: " + FullName + " is not comm metadata");
+    }
+
+    //
+    // Items whose BoxArrays or DistributionMappings are not in the Header
+    // are read and dropped.
+    //
+    auto findBD = [] (BDHash h) -> LoadedBD*
+    {
+        auto it = m_LoadedBD.find(h);
+        return (it == m_LoadedBD.end()) ? nullptr : &(it->second);
+    };
+
+    long n;
+    int  flag;
+    IntVect period;
+    BDHash h0, h1, h2;
+
+    readPOD(ifs, n);
+    for (long i = 0; i < n; ++i)
+    {
+        std::unique_ptr<FB> fb(new FB());
+        readPOD(ifs, h0);
+        readPOD(ifs, fb->m_ngrow);
+        readPOD(ifs, flag);  fb->m_cross = flag;
+        readPOD(ifs, flag);  fb->m_epo = flag;
+        readPOD(ifs, period);  fb->m_period = Periodicity(period);
+        readPOD(ifs, flag);  fb->m_threadsafe_loc = flag;
+        readPOD(ifs, flag);  fb->m_threadsafe_rcv = flag;
+        readPODs(ifs, *fb->m_LocTags);
+        readTags(ifs, *fb->m_SndTags);
+        readTags(ifs, *fb->m_RcvTags);
+        readTags(ifs, *fb->m_SndVols);
+        readTags(ifs, *fb->m_RcvVols);
+        if (auto bd = findBD(h0)) {
+            ++(bd->nref);
+            m_LoadedFB.insert(std::make_pair(h0, fb.release()));
+        }
+    }
+
+    readPOD(ifs, n);
+    for (long i = 0; i < n; ++i)
+    {
+        std::unique_ptr<CPC> cpc(new CPC());
+        readPOD(ifs, h0);
+        readPOD(ifs, h1);
+        readPOD(ifs, cpc->m_dstng);
+        readPOD(ifs, cpc->m_srcng);
+        readPOD(ifs, period);  cpc->m_period = Periodicity(period);
+        readPOD(ifs, flag);  cpc->m_threadsafe_loc = flag;
+        readPOD(ifs, flag);  cpc->m_threadsafe_rcv = flag;
+        readPODs(ifs, *cpc->m_LocTags);
+        readTags(ifs, *cpc->m_SndTags);
+        readTags(ifs, *cpc->m_RcvTags);
+        readTags(ifs, *cpc->m_SndVols);
+        readTags(ifs, *cpc->m_RcvVols);
+        auto dstbd = findBD(h0);
+        auto srcbd = findBD(h1);
+        if (dstbd && srcbd) {
+            ++(dstbd->nref);
+            ++(srcbd->nref);
+            m_LoadedCPC.insert(std::make_pair(std::make_pair(h0,h1), cpc.release()));
+        }
+    }
+
+    readPOD(ifs, n);
+    for (long i = 0; i < n; ++i)
+    {
+        std::unique_ptr<FPinfo> fpc(new FPinfo());
+        readPOD(ifs, h0);
+        readPOD(ifs, h1);
+        readPOD(ifs, h2);
+        readPOD(ifs, fpc->m_dstdomain);
+        readPOD(ifs, fpc->m_dstng);
+        readPOD(ifs, fpc->m_crse_dstdomain);
+        readPODs(ifs, fpc->dst_idxs);
+        readPODs(ifs, fpc->dst_boxes);
+        auto dstbd = findBD(h0);
+        auto srcbd = findBD(h1);
+        auto crsebd = (h2 == 0ULL) ? nullptr : findBD(h2);
+        if (dstbd && srcbd && (h2 == 0ULL || crsebd)) {
+            ++(dstbd->nref);
+            ++(srcbd->nref);
+            if (crsebd) {
+                fpc->ba_crse_patch = crsebd->ba;
+                fpc->dm_crse_patch = crsebd->dm;
+            }
+            m_LoadedFPinfo.insert(std::make_pair(std::make_pair(h0,h1), fpc.release()));
+        }
+    }
+
+    if ( ! ifs.good()) {
+        amrex::Error("FabArrayBase::readCommMetaData: failed to read " + FullName);
+    }
+
+    for (auto it = m_LoadedBD.begin(); it != m_LoadedBD.end(); ) {
+        if (it->second.nref == 0) {
+            it = m_LoadedBD.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool
+FabArrayBase::matchLoadedBD (BDHash h, const BoxArray& ba, const DistributionMapping& dm)
+{
+    auto it = m_LoadedBD.find(h);
+    return it != m_LoadedBD.end() && sameBD(it->second.ba, it->second.dm, ba, dm);
+}
+
+void
+FabArrayBase::releaseLoadedBD (BDHash h)
+{
+    auto it = m_LoadedBD.find(h);
+    if (it != m_LoadedBD.end() && --(it->second.nref) == 0) {
+        m_LoadedBD.erase(it);
+    }
+}
+
+void
+FabArrayBase::clearCommMetaData ()
+{
+    for (auto const& kv : m_LoadedFB) {
+        delete kv.second;
+    }
+    for (auto const& kv : m_LoadedCPC) {
+        delete kv.second;
+    }
+    for (auto const& kv : m_LoadedFPinfo) {
+        delete kv.second;
+    }
+    m_LoadedFB.clear();
+    m_LoadedCPC.clear();
+    m_LoadedFPinfo.clear();
+    m_LoadedBD.clear();
 }
 
 void
@@ -0,0 +1,143 @@
+
+#include <cstdint>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <AMReX_BLassert.H>
+#include <AMReX_HArena.H>
+
+namespace amrex {
+
+HArena::HArena (std::size_t hunk_size, bool use_hugetlb)
+    :
+    CArena(hunk_size),
+    m_use_hugetlb(use_hugetlb),
+    m_huge(0),
+    m_hugetlb(0)
+{
+    m_hunk = (m_hunk + HugePageSize - 1) / HugePageSize * HugePageSize;
+}
+
+HArena::~HArena ()
+{
+    for (const Hunk& h : m_hunks)
+    {
+        if (h.m_kind == Heap)
+            ::operator delete(h.m_ptr);
+        else
+            ::munmap(h.m_ptr, h.m_size);
+    }
+    //
+    // Keep ~CArena() from deleting them again.
+    //
+    m_alloc.clear();
+}
+
+void*
+HArena::allocate_hunk (std::size_t& N)
+{
+    N = (N + HugePageSize - 1) / HugePageSize * HugePageSize;
+
+    void*    vp   = 0;
+    HunkKind kind = Heap;
+
+#ifdef MAP_HUGETLB
+    if (m_use_hugetlb)
+    {
+        vp = ::mmap(0, N, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+        if (vp == MAP_FAILED)
+        {
+            //
+            // No pool configured, or it's used up.  Don't keep asking.
+            //
+            vp = 0;
+            m_use_hugetlb = false;
+        }
+        else
+        {
+            kind = HugeTLB;
+        }
+    }
+#endif
+
+    if (vp == 0)
+    {
+        //
+        // Over-map by a huge page and trim, so the hunk starts on a huge
+        // page boundary and the kernel can back all of it with huge pages.
+        //
+        const std::size_t M = N + HugePageSize;
+
+        void* mp = ::mmap(0, M, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (mp != MAP_FAILED)
+        {
+            char* lo = static_cast<char*>(mp);
+            char* p  = reinterpret_cast<char*>(
+                (reinterpret_cast<std::uintptr_t>(lo) + HugePageSize - 1)
+                / HugePageSize * HugePageSize);
+
+            if (p > lo)
+                ::munmap(lo, p - lo);
+            if (p + N < lo + M)
+                ::munmap(p + N, (lo + M) - (p + N));
+
+            vp   = p;
+            kind = Mapped;
+#ifdef MADV_HUGEPAGE
+            if (::madvise(vp, N, MADV_HUGEPAGE) == 0)
+                kind = Advised;
+#endif
+        }
+    }
+
+    if (vp == 0)
+        vp = ::operator new(N);
+
+    Hunk h = { vp, N, kind };
+    m_hunks.push_back(h);
+
+    if (kind == Advised || kind == HugeTLB)
+        m_huge += N;
+    if (kind == HugeTLB)
+        m_hugetlb += N;
+
+    return vp;
+}
+
+void*
+HArena::alloc (std::size_t nbytes)
+{
+    void* vp = 0;
+#ifdef _OPENMP
+#pragma omp critical(harena_lock)
+#endif
+    vp = CArena::alloc(nbytes);
+    return vp;
+}
+
+void
+HArena::free (void* vp)
+{
+#ifdef _OPENMP
+#pragma omp critical(harena_lock)
+#endif
+    CArena::free(vp);
+}
+
+std::size_t
+HArena::huge_space_used () const
+{
+    return m_huge;
+}
+
+std::size_t
+HArena::hugetlb_space_used () const
+{
+    return m_hugetlb;
+}
+
+}
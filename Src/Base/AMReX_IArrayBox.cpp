@@ -45,6 +45,12 @@ IArrayBox::IArrayBox (const IArrayBox& rhs, MakeType make_type, int scomp, int n
 {
 }
 
+IArrayBox::IArrayBox (const Box& b, int ncomp, int* p)
+    :
+    BaseFab<int>(b,ncomp,p)
+{
+}
+
 IArrayBox&
 IArrayBox::operator= (const int& v)
 {
@@ -2,6 +2,7 @@
 #include <AMReX_MFIter.H>
 #include <AMReX_FabArray.H>
 #include <AMReX_FArrayBox.H>
+#include <AMReX_LayoutData.H>
 
 namespace amrex {
 
@@ -14,6 +15,7 @@ MFIter::MFIter (const FabArrayBase& fabarray_,
     tile_size((flags_ & Tiling) ? FabArrayBase::mfiter_tile_size : IntVect::TheZeroVector()),
     flags(flags_),
     dynamic(false),
+    shellIndex(-1),
     index_map(nullptr),
     local_index_map(nullptr),
     tile_array(nullptr),
@@ -30,6 +32,7 @@ MFIter::MFIter (const FabArrayBase& fabarray_,
     tile_size((do_tiling_) ? FabArrayBase::mfiter_tile_size : IntVect::TheZeroVector()),
     flags(do_tiling_ ? Tiling : 0),
     dynamic(false),
+    shellIndex(-1),
     index_map(nullptr),
     local_index_map(nullptr),
     tile_array(nullptr),
@@ -47,6 +50,7 @@ MFIter::MFIter (const FabArrayBase& fabarray_,
     tile_size(tilesize_),
     flags(flags_ | Tiling),
     dynamic(false),
+    shellIndex(-1),
     index_map(nullptr),
     local_index_map(nullptr),
     tile_array(nullptr),
@@ -65,6 +69,7 @@ MFIter::MFIter (const BoxArray& ba, const DistributionMapping& dm, unsigned char
     tile_size((flags_ & Tiling) ? FabArrayBase::mfiter_tile_size : IntVect::TheZeroVector()),
     flags(flags_),
     dynamic(false),
+    shellIndex(-1),
     index_map(nullptr),
     local_index_map(nullptr),
     tile_array(nullptr),
@@ -83,6 +88,7 @@ MFIter::MFIter (const BoxArray& ba, const DistributionMapping& dm, bool do_tilin
     tile_size((do_tiling_) ? FabArrayBase::mfiter_tile_size : IntVect::TheZeroVector()),
     flags(do_tiling_ ? Tiling : 0),
     dynamic(false),
+    shellIndex(-1),
     index_map(nullptr),
     local_index_map(nullptr),
     tile_array(nullptr),
@@ -103,6 +109,7 @@ MFIter::MFIter (const BoxArray& ba, const DistributionMapping& dm,
     tile_size(tilesize_),
     flags(flags_ | Tiling),
     dynamic(false),
+    shellIndex(-1),
     index_map(nullptr),
     local_index_map(nullptr),
     tile_array(nullptr),
@@ -117,13 +124,15 @@ MFIter::MFIter (const FabArrayBase& fabarray_, const MFItInfo& info)
     :
     fabArray(fabarray_),
     tile_size(info.tilesize),
-    flags(info.do_tiling ? Tiling : 0),
-    dynamic(info.dynamic),
+    flags((info.do_tiling ? Tiling : 0) | (info.interior_first ? InteriorFirst : 0)),
+    dynamic(info.dynamic && !info.interior_first),
+    shellIndex(-1),
     index_map(nullptr),
     local_index_map(nullptr),
     tile_array(nullptr),
     local_tile_index_map(nullptr),
-    num_local_tiles(nullptr)
+    num_local_tiles(nullptr),
+    m_cost(info.cost)
 {
     if (dynamic) {
 #ifdef _OPENMP
@@ -136,11 +145,17 @@ MFIter::MFIter (const FabArrayBase& fabarray_, const MFItInfo& info)
     }
 
     Initialize();
+
+    if (m_cost) {
+        m_cost_t0 = ParallelDescriptor::second();
+    }
 }
 
 
 MFIter::~MFIter ()
 {
+    if (m_cost && isValid()) addCost();  // the loop was left early
+
 #if BL_USE_TEAM
     if ( ! (flags & NoTeamBarrier) )
 	ParallelDescriptor::MyTeam().MemoryBarrier();
@@ -155,6 +170,7 @@ MFIter::Initialize ()
     }
     else if (flags & AllBoxes)  // a very special case
     {
+	BL_ASSERT(!(flags & InteriorFirst));
 	index_map    = &(fabArray.IndexArray());
 	currentIndex = 0;
 	beginIndex   = 0;
@@ -236,9 +252,96 @@ MFIter::Initialize ()
 	currentIndex = beginIndex;
 
 	typ = fabArray.boxArray().ixType();
+
+	if (flags & InteriorFirst) {
+	    InitializeInteriorFirst();
+	}
+    }
+}
+
+void
+MFIter::InitializeInteriorFirst ()
+{
+    BL_ASSERT(!dynamic);
+
+    m_ifta.reset(new FabArrayBase::TileArray);
+    FabArrayBase::TileArray& ta = *m_ifta;
+    ta.nuse = 0;
+
+    const int ng = fabArray.nGrow();
+
+    auto push = [&] (int i, const Box& bx) {
+	ta.indexMap.push_back((*index_map)[i]);
+	ta.localIndexMap.push_back((*local_index_map)[i]);
+	ta.localTileIndexMap.push_back((*local_tile_index_map)[i]);
+	ta.numLocalTiles.push_back((*num_local_tiles)[i]);
+	ta.tileArray.push_back(bx);
+    };
+
+    // Interior parts of our tiles first, then the shells.
+    for (int pass = 0; pass < 2; ++pass)
+    {
+	if (pass == 1) {
+	    shellIndex = ta.indexMap.size();
+	}
+
+	for (int i = beginIndex; i < endIndex; ++i)
+	{
+	    const Box& tbx = (*tile_array)[i];
+	    const Box& vbx = amrex::enclosedCells(fabArray.box((*index_map)[i]));
+	    const Box& ibx = tbx & amrex::grow(vbx, -ng);
+
+	    if (pass == 0) {
+		if (ibx.ok()) push(i, ibx);
+	    } else if (ibx.ok()) {
+		const BoxList& shell = amrex::boxDiff(tbx, ibx);
+		for (const Box& bx : shell) push(i, bx);
+	    } else {
+		push(i, tbx);
+	    }
+	}
+    }
+
+    index_map            = &(ta.indexMap);
+    local_index_map      = &(ta.localIndexMap);
+    tile_array           = &(ta.tileArray);
+    local_tile_index_map = &(ta.localTileIndexMap);
+    num_local_tiles      = &(ta.numLocalTiles);
+
+    currentIndex = beginIndex = 0;
+    endIndex = ta.indexMap.size();
+
+    // No interior work for this thread
+    if (shellIndex == 0) finishInterior();
+}
+
+void
+MFIter::finishInterior ()
+{
+    // The implied barrier at the end of single makes sure no thread
+    // starts on its shell before the ghost cells are filled.
+#ifdef _OPENMP
+#pragma omp single
+#endif
+    const_cast<FabArrayBase&>(fabArray).FillBoundary_finish();
+
+    if (m_cost) {
+        m_cost_t0 = ParallelDescriptor::second();  // not charged to any box
     }
 }
 
+void
+MFIter::addCost ()
+{
+    const Real t = ParallelDescriptor::second();
+    Real& c = (*m_cost)[*this];
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    c += t - m_cost_t0;
+    m_cost_t0 = t;
+}
+
 Box 
 MFIter::tilebox () const
 { 
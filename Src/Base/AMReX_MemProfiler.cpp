@@ -18,6 +18,34 @@
 
 namespace amrex {
 
+#ifdef __linux
+namespace
+{
+    //
+    // Sum the kB values of every line of fname starting with token, e.g.
+    // AnonHugePages: in smaps.  Returns -1 if the file can't be read.
+    //
+    long
+    sumProcField (const std::string& fname, const std::string& field)
+    {
+        std::ifstream ifs(fname.c_str());
+        if (!ifs.good()) return -1L;
+        long total = 0L;
+        std::string token, unit;
+        long n;
+        while (ifs >> token) {
+            if (token == field) {
+                ifs >> n >> unit;
+                if (unit != "kB") return -1L;
+                total += n * 1024L;
+            }
+            ifs.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        return total;
+    }
+}
+#endif
+
 void 
 MemProfiler::add (const std::string& name, std::function<MemInfo()>&& f)
 {
@@ -89,7 +117,7 @@ MemProfiler::report_ (const std::string& prefix, const std::string& memory_log_n
     std::vector<int>  hwm_builds_max = hwm_builds_min;
 
 #ifdef __linux
-    const int N = 9;
+    const int N = 11;
 #else
     const int N = 1;
 #endif
@@ -188,6 +216,23 @@ MemProfiler::report_ (const std::string& prefix, const std::string& memory_log_n
 	    }
 	}
     }
+
+    // Huge page coverage: anonymous memory backed by transparent huge
+    // pages, and pages taken from the reserved (hugetlbfs) pool.
+    int ierr_huge = 0;
+    const int ihuge = isinfo + nsinfo;
+    const int nhuge = 2;
+    {
+	long anon = sumProcField("/proc/self/smaps_rollup", "AnonHugePages:");
+	if (anon < 0) anon = sumProcField("/proc/self/smaps", "AnonHugePages:");
+	long tlb = sumProcField("/proc/self/status", "HugetlbPages:");
+	if (anon < 0 || tlb < 0) {
+	    ierr_huge = -1;
+	} else {
+	    mymin[ihuge+0] = mymax[ihuge+0] = anon;
+	    mymin[ihuge+1] = mymax[ihuge+1] = tlb;
+	}
+    }
 #endif
 
     const int IOProc = ParallelDescriptor::IOProcessorNumber();
@@ -295,6 +340,16 @@ MemProfiler::report_ (const std::string& prefix, const std::string& memory_log_n
 	    memlog << "\n";
 	}
 
+	if (ierr_huge == 0) {
+	    memlog << "\n";
+	    memlog << " * " << std::setw(width_bytes) << std::left << "Proc AnonHugePages"
+		   << "   " << std::setw(width_bytes) << "HugetlbPages" << "\n";
+	    memlog << "  ";
+	    for (int i = 0; i < nhuge; ++i)
+		memlog << " [" << Bytes{mymin[ihuge+i], mymax[ihuge+i]} << "]";
+	    memlog << "\n";
+	}
+
 	if (ierr_sysinfo == 0) {
 	    memlog << "\n";
 	    memlog << " * " << std::setw(width_bytes) << std::left << "Node total"
@@ -0,0 +1,84 @@
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <AMReX.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_NArena.H>
+
+namespace amrex {
+
+Arena*
+The_Numa_Arena ()
+{
+    static NArena the_numa_arena;
+    return &the_numa_arena;
+}
+
+NArena::~NArena ()
+{
+    for (const auto& kv : m_block)
+        ::munmap(kv.first, kv.second);
+}
+
+std::size_t
+NArena::pageSize ()
+{
+    static const std::size_t page_size = ::sysconf(_SC_PAGESIZE);
+    return page_size;
+}
+
+void*
+NArena::alloc (std::size_t nbytes)
+{
+    const std::size_t pg = pageSize();
+    const std::size_t N  = ((nbytes == 0 ? 1 : nbytes) + pg - 1) / pg * pg;
+
+    void* vp = ::mmap(0, N, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (vp == MAP_FAILED)
+        amrex::Abort("NArena::alloc: mmap failed");
+
+#ifdef _OPENMP
+#pragma omp critical(narena_lock)
+#endif
+    {
+        m_block[vp] = N;
+        m_used += N;
+    }
+
+    return vp;
+}
+
+void
+NArena::free (void* vp)
+{
+    if (vp == 0)
+        //
+        // Allow calls with NULL as allowed by C++ delete.
+        //
+        return;
+
+    std::size_t N = 0;
+
+#ifdef _OPENMP
+#pragma omp critical(narena_lock)
+#endif
+    {
+        auto it = m_block.find(vp);
+        BL_ASSERT(it != m_block.end());
+        N = it->second;
+        m_block.erase(it);
+        m_used -= N;
+    }
+
+    ::munmap(vp, N);
+}
+
+std::size_t
+NArena::heap_space_used () const
+{
+    return m_used;
+}
+
+}
@@ -0,0 +1,215 @@
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+
+#include <AMReX.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_BaseFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ScratchPad.H>
+
+#ifdef BL_MEM_PROFILING
+#include <AMReX_MemProfiler.H>
+#endif
+
+namespace amrex {
+
+std::size_t ScratchPad::min_chunk_bytes = 1024*1024;
+
+namespace
+{
+    //
+    // One pad per thread of the outermost parallel region.  Allocated on
+    // the heap so nothing is left to free after The_Arena() is gone.
+    //
+    std::vector<ScratchPad>* the_pads = 0;
+
+    bool initialized = false;
+}
+
+ScratchPad::~ScratchPad ()
+{
+    for (const Chunk& c : m_chunk)
+        The_Arena()->free(c.m_ptr);
+}
+
+ScratchPad::ScratchPad (ScratchPad&& rhs) noexcept
+    :
+    m_chunk(std::move(rhs.m_chunk)),
+    m_cur(rhs.m_cur),
+    m_off(rhs.m_off),
+    m_capacity(rhs.m_capacity)
+{
+    rhs.m_chunk.clear();
+    rhs.m_cur = rhs.m_off = rhs.m_capacity = 0;
+}
+
+void*
+ScratchPad::alloc (std::size_t nbytes)
+{
+    nbytes = (std::max(nbytes, std::size_t(1)) + Align - 1) / Align * Align;
+
+    for (;;)
+    {
+        if (m_cur < m_chunk.size())
+        {
+            const Chunk& c = m_chunk[m_cur];
+
+            if (m_off + nbytes <= c.m_size)
+            {
+                void* vp = c.m_base + m_off;
+                m_off += nbytes;
+                return vp;
+            }
+            //
+            // The rest of this chunk is skipped; try the next one if any.
+            //
+            if (m_cur + 1 < m_chunk.size())
+            {
+                ++m_cur;
+                m_off = 0;
+                continue;
+            }
+        }
+
+        grow(nbytes);
+    }
+}
+
+void
+ScratchPad::grow (std::size_t nbytes)
+{
+    //
+    // Double the capacity each time, so a loop settles after a few tiles.
+    //
+    const std::size_t N = std::max(nbytes, std::max(m_capacity, min_chunk_bytes));
+
+    void* vp   = The_Arena()->alloc(N + Align);
+    char* base = reinterpret_cast<char*>(
+        (reinterpret_cast<std::uintptr_t>(vp) + Align - 1) / Align * Align);
+
+    Chunk c = { vp, base, N };
+
+    m_chunk.push_back(c);
+    m_capacity += N;
+    m_cur = m_chunk.size() - 1;
+    m_off = 0;
+}
+
+void
+ScratchPad::release (const Mark& m)
+{
+    BL_ASSERT(m.m_chunk < m_cur || (m.m_chunk == m_cur && m.m_off <= m_off));
+
+    m_cur = m.m_chunk;
+    m_off = m.m_off;
+
+    //
+    // Once the outermost scope is done, merge what the pad grew into, so
+    // the next tile fits in one chunk.
+    //
+    if (m_cur == 0 && m_off == 0 && m_chunk.size() > 1)
+        consolidate();
+}
+
+void
+ScratchPad::consolidate ()
+{
+    const std::size_t N = m_capacity;
+
+    for (const Chunk& c : m_chunk)
+        The_Arena()->free(c.m_ptr);
+
+    m_chunk.clear();
+    m_capacity = 0;
+    m_cur = 0;
+
+    grow(N);
+}
+
+ScratchPad*
+ScratchPad::get ()
+{
+    if (the_pads == 0) return 0;
+#ifdef _OPENMP
+    if (omp_get_level() > 1) return 0;
+    const std::size_t tid = omp_get_thread_num();
+#else
+    const std::size_t tid = 0;
+#endif
+    return (tid < the_pads->size()) ? &(*the_pads)[tid] : 0;
+}
+
+void
+ScratchPad::Initialize ()
+{
+    if (initialized) return;
+    initialized = true;
+
+    ParmParse pp("fab");
+
+    long nbytes = min_chunk_bytes;
+    pp.query("scratch_chunk_bytes", nbytes);
+    min_chunk_bytes = std::max(nbytes, long(Align));
+
+#ifdef _OPENMP
+    const int nthreads = omp_get_max_threads();
+#else
+    const int nthreads = 1;
+#endif
+
+    the_pads = new std::vector<ScratchPad>(nthreads);
+
+    amrex::ExecOnFinalize(ScratchPad::Finalize);
+
+#ifdef BL_MEM_PROFILING
+    static bool profiled = false;
+    if (!profiled) {
+	profiled = true;
+	MemProfiler::add("ScratchPad", std::function<MemProfiler::MemInfo()>
+			 ([] () -> MemProfiler::MemInfo {
+			     static long hwm = 0;
+			     long cap = 0;
+			     if (the_pads) {
+				 for (const ScratchPad& p : *the_pads)
+				     cap += p.capacity();
+			     }
+			     hwm = std::max(hwm, cap);
+			     return {cap, hwm};
+			 }));
+    }
+#endif
+}
+
+void
+ScratchPad::Finalize ()
+{
+    delete the_pads;
+    the_pads = 0;
+    initialized = false;
+}
+
+ScratchScope::ScratchScope ()
+    :
+    m_pad(ScratchPad::get()),
+    m_own(0)
+{
+    if (m_pad == 0)
+        m_pad = m_own = new ScratchPad;
+
+    m_mark = m_pad->mark();
+}
+
+ScratchScope::~ScratchScope ()
+{
+    if (m_own)
+        delete m_own;
+    else
+        m_pad->release(m_mark);
+}
+
+}
@@ -0,0 +1,385 @@
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+
+#include <AMReX_BLassert.H>
+#include <AMReX_TArena.H>
+
+namespace amrex {
+
+namespace
+{
+    //
+    // Each block is preceded by a header of Arena::align_size bytes that
+    // records its size class, so free() needn't search for it.  Blocks
+    // larger than MaxBlockSize have class NClasses and record their size.
+    //
+    struct BlockHeader
+    {
+        std::size_t cls;
+        std::size_t nbytes;
+    };
+
+    inline BlockHeader* header (void* vp, std::size_t hdr_size)
+    {
+        return reinterpret_cast<BlockHeader*>(static_cast<char*>(vp) - hdr_size);
+    }
+
+    inline void*& next (void* vp)
+    {
+        return *static_cast<void**>(vp);
+    }
+
+    //
+    // The index of the smallest size class that'll hold nbytes.  The
+    // classes between 2^e and 2^(e+1) are NSubClasses steps of 2^e/NSubClasses.
+    //
+    inline int sizeClass (std::size_t nbytes)
+    {
+        if (nbytes <= (std::size_t(1) << TArena::MinClass)) return 0;
+
+        int e = TArena::MinClass;
+        while ((std::size_t(1) << (e+1)) < nbytes) {
+            ++e;
+        }
+        const std::size_t base = std::size_t(1) << e;
+        const std::size_t step = base/TArena::NSubClasses;
+        const int sub = (nbytes - base + step - 1)/step;
+        return (e - TArena::MinClass)*TArena::NSubClasses + sub;
+    }
+
+    //
+    // The cache the calling thread may use without locking, or -1.  Only
+    // threads of the outermost parallel region have a cache of their own;
+    // thread numbers within nested regions aren't unique.
+    //
+    inline int threadCache (int ncache)
+    {
+#ifdef _OPENMP
+        if (omp_get_level() > 1) return -1;
+        const int tid = omp_get_thread_num();
+        return (tid < ncache) ? tid : -1;
+#else
+        return 0;
+#endif
+    }
+}
+
+TArena::TArena (std::size_t hunk_size)
+{
+    static_assert(sizeof(BlockHeader) <= Arena::align_size,
+                  "TArena block header must fit in Arena::align_size");
+    //
+    // Force alignment of hunksize.
+    //
+    m_hunk = Arena::align(hunk_size == 0 ? DefaultHunkSize : hunk_size);
+    m_used = 0;
+
+#ifdef _OPENMP
+    m_cache.resize(omp_get_max_threads());
+#else
+    m_cache.resize(1);
+#endif
+
+    BL_ASSERT(m_hunk >= hunk_size);
+    BL_ASSERT(m_hunk%Arena::align_size == 0);
+}
+
+TArena::~TArena ()
+{
+    for (unsigned int i = 0, N = m_alloc.size(); i < N; i++)
+        ::operator delete(m_alloc[i].m_ptr);
+}
+
+std::size_t
+TArena::classSize (int c)
+{
+    const std::size_t base = std::size_t(1) << (MinClass + c/NSubClasses);
+    return base + (c%NSubClasses)*(base/NSubClasses);
+}
+
+int
+TArena::cacheLimit (int c)
+{
+    const int n = CacheBytes/classSize(c);
+    return std::max(2, std::min(512, n));
+}
+
+void*
+TArena::alloc (std::size_t nbytes)
+{
+    if (nbytes == 0) nbytes = 1;
+
+    if (nbytes > std::size_t(MaxBlockSize))
+    {
+        const std::size_t N = Arena::align(nbytes) + Arena::align_size;
+        char* p = static_cast<char*>(::operator new(N));
+        BlockHeader* hdr = reinterpret_cast<BlockHeader*>(p);
+        hdr->cls    = NClasses;
+        hdr->nbytes = N;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        m_used += N;
+        return p + Arena::align_size;
+    }
+
+    const int c   = sizeClass(nbytes);
+    const int tid = threadCache(m_cache.size());
+
+    if (tid < 0)
+    {
+        FreeList fl;
+        refill(fl, c, 1);
+        return fl.m_head;
+    }
+
+    ThreadCache& tc = m_cache[tid];
+    FreeList&    fl = tc.m_bin[c];
+
+    if (fl.m_head == 0)
+    {
+        const int n = std::max(1, cacheLimit(c)/2);
+        refill(fl, c, n);
+        tc.m_bytes += n*classSize(c);
+    }
+
+    void* vp = fl.m_head;
+    fl.m_head = next(vp);
+    --fl.m_count;
+    tc.m_bytes -= classSize(c);
+
+    BL_ASSERT(!(vp == 0));
+
+    return vp;
+}
+
+void
+TArena::free (void* vp)
+{
+    if (vp == 0)
+        //
+        // Allow calls with NULL as allowed by C++ delete.
+        //
+        return;
+
+    BlockHeader* hdr = header(vp, Arena::align_size);
+
+    if (hdr->cls == std::size_t(NClasses))
+    {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        m_used -= hdr->nbytes;
+        ::operator delete(hdr);
+        return;
+    }
+
+    const int c   = hdr->cls;
+    const int tid = threadCache(m_cache.size());
+
+    BL_ASSERT(c >= 0 && c < NClasses);
+
+    if (tid < 0)
+    {
+        FreeList fl;
+        next(vp) = 0;
+        fl.m_head = vp;
+        fl.m_count = 1;
+        spill(fl, c, 1);
+        return;
+    }
+
+    ThreadCache& tc = m_cache[tid];
+    FreeList&    fl = tc.m_bin[c];
+
+    next(vp) = fl.m_head;
+    fl.m_head = vp;
+    ++fl.m_count;
+    tc.m_bytes += classSize(c);
+
+    if (fl.m_count > cacheLimit(c))
+    {
+        const int n = fl.m_count/2;
+        spill(fl, c, n);
+        tc.m_bytes -= n*classSize(c);
+    }
+
+    if (tc.m_bytes > std::size_t(MaxCacheBytes))
+        spillAll(tc);
+}
+
+void
+TArena::refill (FreeList& fl, int c, int n)
+{
+#ifdef _OPENMP
+#pragma omp critical(tarena_lock)
+#endif
+    {
+        FreeList& central = m_central[c];
+
+        if (central.m_count < n)
+        {
+            //
+            // Carve a new hunk into blocks of this class.
+            //
+            const std::size_t stride = classSize(c) + Arena::align_size;
+            const std::size_t nblocks = std::max(std::size_t(n - central.m_count), m_hunk/stride);
+            const std::size_t N = nblocks*stride;
+
+            char* p = static_cast<char*>(::operator new(N));
+
+            m_alloc.push_back(Hunk{p, N, c, nblocks});
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+            m_used += N;
+
+            for (std::size_t i = 0; i < nblocks; ++i, p += stride)
+            {
+                BlockHeader* hdr = reinterpret_cast<BlockHeader*>(p);
+                hdr->cls    = c;
+                hdr->nbytes = stride;
+                void* vp = p + Arena::align_size;
+                next(vp) = central.m_head;
+                central.m_head = vp;
+            }
+            central.m_count += nblocks;
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            void* vp = central.m_head;
+            central.m_head = next(vp);
+            next(vp) = fl.m_head;
+            fl.m_head = vp;
+        }
+        central.m_count -= n;
+        fl.m_count      += n;
+    }
+}
+
+void
+TArena::spill (FreeList& fl, int c, int n)
+{
+    BL_ASSERT(n <= fl.m_count);
+
+#ifdef _OPENMP
+#pragma omp critical(tarena_lock)
+#endif
+    {
+        FreeList& central = m_central[c];
+
+        for (int i = 0; i < n; ++i)
+        {
+            void* vp = fl.m_head;
+            fl.m_head = next(vp);
+            next(vp) = central.m_head;
+            central.m_head = vp;
+        }
+        central.m_count += n;
+        fl.m_count      -= n;
+    }
+}
+
+void
+TArena::spillAll (ThreadCache& tc)
+{
+    for (int c = 0; c < NClasses; ++c)
+    {
+        if (tc.m_bin[c].m_count > 0)
+            spill(tc.m_bin[c], c, tc.m_bin[c].m_count);
+    }
+    tc.m_bytes = 0;
+}
+
+void
+TArena::release ()
+{
+#ifdef _OPENMP
+    BL_ASSERT(!omp_in_parallel());
+#endif
+
+    for (unsigned int i = 0, N = m_cache.size(); i < N; ++i)
+        spillAll(m_cache[i]);
+    //
+    // Count the free blocks of each hunk.  All blocks are in the central
+    // heap now, so the hunks with as many free blocks as they have can go.
+    //
+    const int NH = m_alloc.size();
+
+    std::vector<std::pair<char*,int> > start(NH);
+    for (int h = 0; h < NH; ++h)
+        start[h] = std::make_pair(m_alloc[h].m_ptr, h);
+    std::sort(start.begin(), start.end());
+
+    auto hunkOf = [&start,NH] (void* vp) -> int
+    {
+        auto it = std::upper_bound(start.begin(), start.end(),
+                                   std::make_pair(static_cast<char*>(vp), NH));
+        BL_ASSERT(it != start.begin());
+        return (--it)->second;
+    };
+
+    std::vector<std::size_t> nfree(NH, 0);
+    for (int c = 0; c < NClasses; ++c)
+    {
+        for (void* vp = m_central[c].m_head; vp != 0; vp = next(vp))
+            ++nfree[hunkOf(vp)];
+    }
+
+    std::vector<char> drop(NH, 0);
+    bool any = false;
+    for (int h = 0; h < NH; ++h)
+    {
+        drop[h] = nfree[h] == m_alloc[h].m_nblocks;
+        any = any || drop[h];
+    }
+    if (!any) return;
+    //
+    // Take their blocks off the free lists before freeing them.
+    //
+    for (int c = 0; c < NClasses; ++c)
+    {
+        FreeList& central = m_central[c];
+        FreeList  kept;
+        for (void* vp = central.m_head; vp != 0; )
+        {
+            void* nx = next(vp);
+            if (!drop[hunkOf(vp)])
+            {
+                next(vp) = kept.m_head;
+                kept.m_head = vp;
+                ++kept.m_count;
+            }
+            vp = nx;
+        }
+        central = kept;
+    }
+
+    std::vector<Hunk> kept;
+    for (int h = 0; h < NH; ++h)
+    {
+        if (drop[h])
+        {
+            m_used -= m_alloc[h].m_size;
+            ::operator delete(m_alloc[h].m_ptr);
+        }
+        else
+        {
+            kept.push_back(m_alloc[h]);
+        }
+    }
+    m_alloc.swap(kept);
+}
+
+std::size_t
+TArena::heap_space_used () const
+{
+    return m_used;
+}
+
+}
@@ -1248,14 +1248,14 @@ void amrex::BroadcastBox(Box &bB, int myLocalId, int rootId, const MPI_Comm &loc
 
 void amrex::BroadcastBoxArray(BoxArray &bBA, int myLocalId, int rootId, const MPI_Comm &localComm)
 {
-  Vector<int> sbaG;
+  Vector<char> sbaG;
   if(myLocalId == rootId) {
-    sbaG = amrex::SerializeBoxArray(bBA);
+    sbaG = amrex::EncodeBoxArray(bBA);
   }
   amrex::BroadcastArray(sbaG, myLocalId, rootId, localComm);
   if(myLocalId != rootId) {
     if(sbaG.size() > 0) {
-      bBA = amrex::UnSerializeBoxArray(sbaG);
+      bBA = amrex::DecodeBoxArray(sbaG);
     }
   }
 }
@@ -1271,14 +1271,33 @@ void amrex::BroadcastDistributionMapping(DistributionMapping &dM,
   }
 
   // ---- Color & dmap
+  // ---- the map is sent as varint deltas, since neighboring boxes
+  // ---- usually live on the same or nearby ranks
   Vector<int> dmapA;
+  Vector<char> dmapEnc;
   int colorInt;
   if(myLocalId == rootId) {
     dmapA = dM.ProcessorMap();
     colorInt = dM.color().to_int();
+    amrex::PutVarint(dmapEnc, dmapA.size());
+    int prev(0);
+    for(int i(0); i < dmapA.size(); ++i) {
+      amrex::PutVarint(dmapEnc, static_cast<long>(dmapA[i]) - prev);
+      prev = dmapA[i];
+    }
   }
-  amrex::BroadcastArray(dmapA, myLocalId, rootId, localComm);
+  amrex::BroadcastArray(dmapEnc, myLocalId, rootId, localComm);
   ParallelDescriptor::Bcast(&colorInt, 1, rootId, localComm);
+  if(myLocalId != rootId && dmapEnc.size() > 0) {
+    const char *p = dmapEnc.dataPtr();
+    const char *pEnd = p + dmapEnc.size();
+    dmapA.resize(amrex::GetVarint(p, pEnd));
+    int prev(0);
+    for(int i(0); i < dmapA.size(); ++i) {
+      prev += amrex::GetVarint(p, pEnd);
+      dmapA[i] = prev;
+    }
+  }
   if(dmapA.size() > 0) {
     if(myLocalId != rootId) {
       ParallelDescriptor::Color colorA(colorInt); 
@@ -0,0 +1,126 @@
+//
+// Array4 must index the same data as BaseFab::operator(), on FABs that
+// include ghost cells, don't start at the origin and have several
+// components, and ParallelFor must visit every cell and component of a
+// box exactly once.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Array4.H>
+#include <AMReX_Loop.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+static
+Real
+fval (const IntVect& iv, int n)
+{
+    Real r = n + 1;
+    for (int d = 0; d < BL_SPACEDIM; ++d) {
+        r = 1000.0*r + iv[d] + 500;
+    }
+    return r;
+}
+
+//
+// The number of cells and components of fab where a doesn't refer to
+// the same element as fab(iv,n).
+//
+template <class T>
+static
+long
+checkView (const FArrayBox& fab, const Array4<T>& a)
+{
+    long nbad = 0;
+    const Box& bx = fab.box();
+    if (a.ncomp != fab.nComp()) ++nbad;
+    for (int n = 0; n < fab.nComp(); ++n) {
+        for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+            const Dim3 c = lbound(Box(iv,iv));
+            if (&a(c.x,c.y,c.z,n) != &fab(iv,n)) ++nbad;
+            if (n == 0 && &a(c.x,c.y,c.z) != &fab(iv)) ++nbad;
+            if (a.ptr(c.x,c.y,c.z,n) != &fab(iv,n)) ++nbad;
+            if (!a.contains(c.x,c.y,c.z)) ++nbad;
+        }
+    }
+    //
+    // And just outside the box.
+    //
+    const Dim3 lo = lbound(bx);
+    const Dim3 hi = ubound(bx);
+    if (a.contains(lo.x-1,lo.y,lo.z) || a.contains(hi.x+1,hi.y,hi.z)) ++nbad;
+    return nbad;
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    long nbad = 0;
+
+    const Box domain(IntVect(AMREX_D_DECL(-9,3,-4)), IntVect(AMREX_D_DECL(22,18,11)));
+    BoxArray ba(domain);
+    ba.maxSize(IntVect(AMREX_D_DECL(16,8,8)));
+    DistributionMapping dm(ba);
+
+    const int ncomp = 3;
+
+    for (const IndexType& typ : {IndexType::TheCellType(), IndexType::TheNodeType()})
+    {
+        MultiFab mf(amrex::convert(ba,typ), dm, ncomp, 2);
+        const MultiFab& cmf = mf;
+
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+        {
+            FArrayBox& fab = mf[mfi];
+
+            nbad += checkView(fab, fab.array());
+            nbad += checkView(fab, fab.const_array());
+            nbad += checkView(fab, mf.array(mfi));
+            nbad += checkView(fab, cmf.array(mfi));
+            nbad += checkView(fab, mf.const_array(mfi));
+
+            Array4<Real> const       a  = mf.array(mfi);
+            Array4<Real const> const ca = a;
+            nbad += checkView(fab, ca);
+
+            //
+            // Write through the view over the whole FAB, ghost cells
+            // included, and read back with operator().
+            //
+            fab.setVal(-1.0);
+            const Box& bx = fab.box();
+            ParallelFor(bx, ncomp, [=] (int i, int j, int k, int n)
+            {
+                IntVect iv(AMREX_D_DECL(i,j,k));
+                a(i,j,k,n) += 1.0 + fval(iv,n);
+            });
+            for (int n = 0; n < ncomp; ++n) {
+                for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                    if (fab(iv,n) != fval(iv,n)) ++nbad;
+                }
+            }
+
+            //
+            // Over a tile inside the FAB, one component.
+            //
+            const Box tbx = amrex::grow(mfi.validbox(), -1);
+            ParallelFor(tbx, [=] (int i, int j, int k) { a(i,j,k) = 0.0; });
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                if (fab(iv,0) != (tbx.contains(iv) ? 0.0 : fval(iv,0))) ++nbad;
+                if (fab(iv,1) != fval(iv,1)) ++nbad;
+            }
+        }
+    }
+
+    ParallelDescriptor::ReduceLongSum(nbad);
+
+    amrex::Print() << (nbad == 0 ? "PASSED" : "FAILED") << " (" << nbad << " bad values)\n";
+
+    amrex::Finalize();
+
+    return nbad != 0;
+}
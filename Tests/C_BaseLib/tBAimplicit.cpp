@@ -0,0 +1,178 @@
+//
+// BoxArrays made by maxSize on one box are stored implicitly when they
+// have more than boxarray.implicit_threshold boxes.  Check that they have
+// the same boxes, in the same order, as BoxList::maxSize, and that they
+// stay the same as an explicitly stored BoxArray through refine, coarsen,
+// grow, convert, set and intersections.
+//
+
+#include <algorithm>
+
+#include <AMReX.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_BoxList.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+static int nfail = 0;
+
+static
+void
+check (bool ok, const std::string& what)
+{
+    if (!ok) {
+        ++nfail;
+        amrex::Print() << "FAILED: " << what << '\n';
+    }
+}
+
+static
+bool
+sameBoxes (const BoxArray& a, const BoxArray& b)
+{
+    if (a.size() != b.size() || a.ixType() != b.ixType()) return false;
+    for (int i = 0, N = a.size(); i < N; ++i) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+static
+std::vector<std::pair<int,Box> >
+sortedIsects (const BoxArray& ba, const Box& bx)
+{
+    std::vector<std::pair<int,Box> > r = ba.intersections(bx);
+    std::sort(r.begin(), r.end(), [] (const std::pair<int,Box>& a, const std::pair<int,Box>& b)
+              { return a.first < b.first; });
+    return r;
+}
+
+int
+main (int argc, char* argv[])
+{
+    //
+    // Make small BoxArrays implicit.
+    //
+    Vector<char*> args(argv, argv+argc);
+    char threshold[] = "boxarray.implicit_threshold=8";
+    args.push_back(threshold);
+    args.push_back(0);
+    int    nargs = argc+1;
+    char** pargs = args.dataPtr();
+
+    amrex::Initialize(nargs,pargs);
+
+    const Box domain(IntVect(AMREX_D_DECL(-5,0,3)), IntVect(AMREX_D_DECL(70,44,33)));
+
+    Vector<IntVect> block_sizes;
+    block_sizes.push_back(IntVect(AMREX_D_DECL(16,16,16)));
+    block_sizes.push_back(IntVect(AMREX_D_DECL(16,8,10)));
+    block_sizes.push_back(IntVect(AMREX_D_DECL(7,13,5)));
+    block_sizes.push_back(IntVect(AMREX_D_DECL(200,9,4)));
+
+    for (const IntVect& bs : block_sizes)
+    {
+        BoxList bl(domain);
+        bl.maxSize(bs);
+
+        BoxArray ba(domain);
+        ba.maxSize(bs);
+
+        //
+        // The explicitly stored reference.
+        //
+        const BoxArray ref(bl);
+
+        check(sameBoxes(ba, ref), "maxSize order");
+
+        {
+            int i = 0;
+            bool same = ba.size() == bl.size();
+            for (auto it = bl.begin(); same && it != bl.end(); ++it, ++i) {
+                same = ba[i] == *it;
+            }
+            check(same, "getImplicitBox order vs BoxList");
+        }
+
+        check(ba.minimalBox() == domain, "minimalBox");
+        check(ba.numPts() == domain.numPts(), "numPts");
+        check(ba.isDisjoint(), "isDisjoint");
+
+        //
+        // Transformations.
+        //
+        {
+            BoxArray a(ba), r(ref);
+            check(sameBoxes(a.refine(2), r.refine(2)), "refine");
+            check(sameBoxes(a.coarsen(4), r.coarsen(4)), "coarsen");
+        }
+        {
+            BoxArray a(ba), r(ref);
+            check(sameBoxes(a.grow(2), r.grow(2)), "grow");
+            check(sameBoxes(a.grow(1,-1), r.grow(1,-1)), "grow in one direction");
+        }
+        {
+            BoxArray a(ba), r(ref);
+            check(sameBoxes(a.convert(IndexType::TheNodeType()),
+                            r.convert(IndexType::TheNodeType())), "convert to nodes");
+            check(sameBoxes(a.enclosedCells(), r.enclosedCells()), "enclosedCells");
+            check(sameBoxes(a.surroundingNodes(0), r.surroundingNodes(0)), "surroundingNodes");
+        }
+        {
+            BoxArray a(ba), r(ref);
+            check(sameBoxes(a.shift(IntVect(AMREX_D_DECL(3,-2,1))),
+                            r.shift(IntVect(AMREX_D_DECL(3,-2,1)))), "shift");
+        }
+
+        //
+        // Intersections.
+        //
+        {
+            Vector<Box> queries;
+            queries.push_back(domain);
+            queries.push_back(Box(IntVect(AMREX_D_DECL(10,10,10)), IntVect(AMREX_D_DECL(20,11,12))));
+            queries.push_back(Box(IntVect(AMREX_D_DECL(-100,-100,-100)), IntVect(AMREX_D_DECL(-6,100,100))));
+            queries.push_back(amrex::grow(ba[ba.size()/2], 1));
+            for (const Box& q : queries) {
+                check(sortedIsects(ba, q) == sortedIsects(ref, q), "intersections");
+            }
+            check(ba.contains(domain), "contains");
+        }
+
+        //
+        // A few exceptions from set, then enough to store the boxes again.
+        //
+        {
+            BoxArray a(ba);
+            BoxList rl(bl);
+            Vector<Box> r(rl.begin(), rl.end());
+            const int N = a.size();
+            for (int k = 0; k < std::min(N, 200); k += 3)
+            {
+                const Box b = amrex::grow(a[k], -1);
+                a.set(k, b);
+                r[k] = b;
+                if (k == 3 || k+3 >= std::min(N, 200))
+                {
+                    bool same = a.size() == N;
+                    for (int i = 0; same && i < N; ++i) {
+                        same = a[i] == r[i];
+                    }
+                    check(same, "set");
+                    const Box q = amrex::grow(r[k], 2);
+                    BoxList rbl;
+                    for (const Box& rb : r) rbl.push_back(rb);
+                    check(sortedIsects(a, q) == sortedIsects(BoxArray(rbl), q),
+                          "intersections after set");
+                }
+            }
+        }
+    }
+
+    amrex::Print() << (nfail == 0 ? "PASSED" : "FAILED") << " (" << nfail << " failures)\n";
+
+    amrex::Finalize();
+
+    return nfail != 0;
+}
@@ -0,0 +1,115 @@
+//
+// Checkpoint -> restart round trip of BoxArrays.  Writes them the way
+// AmrLevel::checkPoint does, in both the text and the writeBinary form,
+// then reads the file back the way Amr::restart does: the whole file
+// through ParallelDescriptor::ReadAndBcastFile into a C string.
+//
+
+#include <fstream>
+#include <sstream>
+
+#include <AMReX.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+using namespace amrex;
+
+static
+BoxArray
+makeBA (const IndexType& typ)
+{
+    //
+    // Negative corners, repeated corners and zero extents, so the encoding
+    // is full of zero deltas, i.e. NUL bytes.
+    //
+    Box domain(IntVect(AMREX_D_DECL(-32,-16,0)), IntVect(AMREX_D_DECL(31,47,63)));
+    BoxArray ba(domain);
+    ba.maxSize(8);
+    BoxList bl(ba);
+    bl.push_back(Box(IntVect::TheZeroVector(), IntVect::TheZeroVector()));
+    bl.push_back(Box(IntVect(AMREX_D_DECL(-100000,7,-3)), IntVect(AMREX_D_DECL(100000,7,-3))));
+    BoxArray r(bl);
+    r.convert(typ);
+    return r;
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    Vector<BoxArray> bas;
+    bas.push_back(makeBA(IndexType::TheCellType()));
+    bas.push_back(makeBA(IndexType::TheNodeType()));
+    bas.push_back(makeBA(IndexType(IntVect::TheDimensionVector(0))));
+
+    const std::string File("tBAio_Header");
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::ofstream os(File.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+        for (int i = 0; i < bas.size(); ++i)
+        {
+            os << i << '\n';
+            bas[i].writeOn(os);
+            os << 42 << '\n';
+            bas[i].writeBinary(os);
+            os << 43 << '\n';
+        }
+    }
+    ParallelDescriptor::Barrier();
+
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(File, fileCharPtr);
+    std::string fileCharPtrString(fileCharPtr.dataPtr());
+    std::istringstream is(fileCharPtrString, std::istringstream::in);
+
+    int nfail = 0;
+
+    for (int i = 0; i < bas.size(); ++i)
+    {
+        int lev, a, b;
+        BoxArray text, special;
+        is >> lev;
+        text.readFrom(is);
+        is >> a;
+        //
+        // AmrLevel::restart with bReadSpecial goes through readBoxArray.
+        //
+        amrex::readBoxArray(special, is, true);
+        is >> b;
+
+        if (lev != i || a != 42 || b != 43) ++nfail;
+        if (text != bas[i])                 ++nfail;
+        if (special != bas[i])              ++nfail;
+    }
+
+    std::istringstream is2(fileCharPtrString, std::istringstream::in);
+    for (int i = 0; i < bas.size(); ++i)
+    {
+        int lev, a, b;
+        BoxArray text, binary;
+        is2 >> lev;
+        text.readFrom(is2);
+        is2 >> a;
+        binary.readFrom(is2);
+        is2 >> b;
+        if (binary != bas[i] || binary.ixType() != bas[i].ixType()) ++nfail;
+    }
+
+    //
+    // The form used for broadcasting.
+    //
+    for (int i = 0; i < bas.size(); ++i)
+    {
+        if (amrex::DecodeBoxArray(amrex::EncodeBoxArray(bas[i])) != bas[i]) ++nfail;
+    }
+
+    amrex::Print() << (nfail == 0 ? "PASSED" : "FAILED") << " (" << nfail << " failures)\n";
+
+    amrex::Finalize();
+
+    return nfail != 0;
+}
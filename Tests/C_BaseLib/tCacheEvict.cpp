@@ -0,0 +1,165 @@
+//
+// FillBoundary and ParallelCopy with fabarray.cache_max_bytes=1, so every
+// new cache item evicts the others that are not in use.  The results must
+// not change, the caches must stay small, and items in use by a nowait
+// operation must survive until its finish.  Run it on several MPI
+// processes, also with fabarray.use_persistent_comm=1.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+static
+Real
+fval (const IntVect& iv, int n)
+{
+    Real r = n + 1;
+    for (int d = 0; d < BL_SPACEDIM; ++d) {
+        r = 100.0*r + iv[d];
+    }
+    return r;
+}
+
+static
+void
+setValid (MultiFab& mf)
+{
+    mf.setVal(-1.e30);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        FArrayBox& fab = mf[mfi];
+        for (int n = 0; n < mf.nComp(); ++n) {
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                fab(iv,n) = fval(iv,n);
+            }
+        }
+    }
+}
+
+//
+// The number of cells of bx in each FAB of mf with the wrong value.
+//
+static
+long
+checkCells (const MultiFab& mf, const Box& domain, bool ghost)
+{
+    long nbad = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const Box bx = (ghost ? mfi.fabbox() : mfi.validbox()) & domain;
+        const FArrayBox& fab = mf[mfi];
+        for (int n = 0; n < mf.nComp(); ++n) {
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                if (fab(iv,n) != fval(iv,n)) ++nbad;
+            }
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(nbad);
+    return nbad;
+}
+
+int
+main (int argc, char* argv[])
+{
+    Vector<char*> args(argv, argv+argc);
+    char max_bytes[] = "fabarray.cache_max_bytes=1";
+    args.push_back(max_bytes);
+    args.push_back(0);
+    int    nargs = argc+1;
+    char** pargs = args.dataPtr();
+
+    amrex::Initialize(nargs,pargs);
+
+    const Box domain(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(47,47,47)));
+
+    const int ncomp = 2;
+    const int ngrow = 1;
+
+    Vector<std::unique_ptr<MultiFab> > mfs;
+    for (int ms : {8, 12, 16, 24})
+    {
+        BoxArray ba(domain);
+        ba.maxSize(ms);
+        DistributionMapping dm(ba);
+        mfs.emplace_back(new MultiFab(ba, dm, ncomp, ngrow));
+    }
+
+    long nbad  = 0;
+    int  nfail = 0;
+
+    //
+    // Blocking fills of different layouts in turn.  Each one evicts the
+    // FB item of the one before, unless it has neighbor collective plans,
+    // which only trimCaches evicts.
+    //
+    const bool nbr = FabArrayBase::use_neighbor_collectives && ParallelDescriptor::NProcs() > 1;
+
+    for (int iter = 0; iter < 2; ++iter)
+    {
+        for (auto& mf : mfs)
+        {
+            setValid(*mf);
+            mf->FillBoundary();
+            nbad += checkCells(*mf, domain, true);
+            if (!nbr && FabArrayBase::cacheStats()[1].size > 1) ++nfail;
+        }
+    }
+    if (!nbr && FabArrayBase::cacheStats()[1].nevict == 0) ++nfail;
+
+    //
+    // Fills of two layouts in flight at once.
+    //
+    for (int iter = 0; iter < 2; ++iter)
+    {
+        setValid(*mfs[0]);
+        setValid(*mfs[1]);
+        mfs[0]->FillBoundary_nowait();
+        mfs[1]->FillBoundary_nowait();
+        mfs[iter]->FillBoundary_finish();
+        mfs[1-iter]->FillBoundary_finish();
+        nbad += checkCells(*mfs[0], domain, true);
+        nbad += checkCells(*mfs[1], domain, true);
+    }
+
+    //
+    // A ParallelCopy in flight while another one builds a new CPC item.
+    //
+    {
+        MultiFab dst(mfs[2]->boxArray(), mfs[2]->DistributionMap(), ncomp, 0);
+        MultiFab dst2(mfs[3]->boxArray(), mfs[3]->DistributionMap(), ncomp, 0);
+        setValid(*mfs[0]);
+        setValid(*mfs[1]);
+        dst.setVal(0.0);
+        dst2.setVal(0.0);
+        dst.ParallelCopy_nowait(*mfs[0]);
+        dst2.ParallelCopy(*mfs[1]);
+        dst.ParallelCopy_finish();
+        nbad += checkCells(dst, domain, false);
+        nbad += checkCells(dst2, domain, false);
+    }
+
+    //
+    // Nothing is in use now, and trimCaches evicts every FB item.
+    //
+    FabArrayBase::trimCaches(1);
+    FabArrayBase::freeNeighborComms();
+    if (FabArrayBase::cacheStats()[1].size != 0) ++nfail;
+
+    setValid(*mfs[0]);
+    mfs[0]->FillBoundary();
+    nbad += checkCells(*mfs[0], domain, true);
+
+    ParallelDescriptor::ReduceIntSum(nfail);
+
+    amrex::Print() << (nbad == 0 && nfail == 0 ? "PASSED" : "FAILED")
+                   << " (" << nbad << " bad cells, " << nfail << " failures)\n";
+
+    amrex::Finalize();
+
+    return nbad != 0 || nfail != 0;
+}
@@ -0,0 +1,167 @@
+//
+// writeCommMetaData -> readCommMetaData round trip.  The FB and CPC items
+// taken from the metadata must have the same tags as those built from
+// scratch, and items that match no FabArray must not be taken.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+//
+// Gets at the caches of FabArrayBase.
+//
+class TMF
+    : public MultiFab
+{
+public:
+    TMF (const BoxArray& ba, const DistributionMapping& dm, int ncomp, int ngrow)
+        : MultiFab(ba, dm, ncomp, ngrow) {}
+
+    struct Tags
+    {
+        FabArrayBase::CopyComTagsContainer      loc;
+        FabArrayBase::MapOfCopyComTagContainers snd, rcv, sndv, rcvv;
+    };
+
+    Tags FBTags (const Periodicity& period) const {
+        const FB& fb = getFB(period);
+        return Tags{*fb.m_LocTags, *fb.m_SndTags, *fb.m_RcvTags, *fb.m_SndVols, *fb.m_RcvVols};
+    }
+
+    Tags CPCTags (const TMF& src, const Periodicity& period) const {
+        const CPC& cpc = getCPC(nGrow(), src, src.nGrow(), period);
+        return Tags{*cpc.m_LocTags, *cpc.m_SndTags, *cpc.m_RcvTags, *cpc.m_SndVols, *cpc.m_RcvVols};
+    }
+
+    static void flushCaches () {
+        flushFBCache();
+        flushCPCache();
+    }
+
+    static long numLoaded () {
+        return m_LoadedFB.size() + m_LoadedCPC.size() + m_LoadedFPinfo.size();
+    }
+
+    static long numLoadedBD () { return m_LoadedBD.size(); }
+};
+
+static
+bool
+sameTags (const FabArrayBase::CopyComTagsContainer& a,
+          const FabArrayBase::CopyComTagsContainer& b)
+{
+    if (a.size() != b.size()) return false;
+    for (int i = 0, N = a.size(); i < N; ++i) {
+        if (a[i].dbox     != b[i].dbox     || a[i].sbox     != b[i].sbox ||
+            a[i].dstIndex != b[i].dstIndex || a[i].srcIndex != b[i].srcIndex) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static
+bool
+sameTags (const FabArrayBase::MapOfCopyComTagContainers& a,
+          const FabArrayBase::MapOfCopyComTagContainers& b)
+{
+    if (a.size() != b.size()) return false;
+    for (auto ita = a.begin(), itb = b.begin(); ita != a.end(); ++ita, ++itb) {
+        if (ita->first != itb->first || !sameTags(ita->second, itb->second)) return false;
+    }
+    return true;
+}
+
+static
+bool
+sameTags (const TMF::Tags& a, const TMF::Tags& b)
+{
+    return sameTags(a.loc, b.loc) && sameTags(a.snd, b.snd) && sameTags(a.rcv, b.rcv)
+        && sameTags(a.sndv, b.sndv) && sameTags(a.rcvv, b.rcvv);
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    int nfail = 0;
+
+    const Box domain(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(63,63,63)));
+    const Periodicity period(IntVect(AMREX_D_DECL(64,64,64)));
+
+    BoxArray ba(domain);
+    ba.maxSize(16);
+    DistributionMapping dm(ba);
+
+    BoxArray ba2(domain);
+    ba2.maxSize(IntVect(AMREX_D_DECL(32,8,16)));
+    DistributionMapping dm2(ba2);
+
+    const std::string dir("tCommMetaData_dir");
+
+    TMF::Tags fb0, cpc0;
+    {
+        TMF dst(ba, dm, 2, 2);
+        TMF src(ba2, dm2, 2, 1);
+        fb0  = dst.FBTags(period);
+        cpc0 = dst.CPCTags(src, period);
+        FabArrayBase::writeCommMetaData(dir);
+    }
+
+    TMF::flushCaches();
+    FabArrayBase::readCommMetaData(dir);
+
+    if (TMF::numLoaded() != 2) ++nfail;
+
+    //
+    // The same boxes and processors in new BoxArrays and DistributionMappings.
+    //
+    BoxArray nba(domain);
+    nba.maxSize(16);
+    DistributionMapping ndm(dm.ProcessorMap());
+
+    BoxArray nba2(domain);
+    nba2.maxSize(IntVect(AMREX_D_DECL(32,8,16)));
+    DistributionMapping ndm2(dm2.ProcessorMap());
+
+    {
+        //
+        // No item for this one.
+        //
+        TMF other(nba2, ndm2, 2, 2);
+        other.FBTags(period);
+        if (TMF::numLoaded() != 2) ++nfail;
+    }
+
+    {
+        TMF dst(nba, ndm, 2, 2);
+        TMF src(nba2, ndm2, 2, 1);
+
+        const long nload_fb  = FabArrayBase::cacheStats()[1].nload;
+        const long nload_cpc = FabArrayBase::cacheStats()[2].nload;
+
+        if (!sameTags(dst.FBTags(period), fb0))        ++nfail;
+        if (!sameTags(dst.CPCTags(src, period), cpc0)) ++nfail;
+
+        if (FabArrayBase::cacheStats()[1].nload != nload_fb+1)  ++nfail;
+        if (FabArrayBase::cacheStats()[2].nload != nload_cpc+1) ++nfail;
+
+        //
+        // The BoxArrays and DistributionMappings read go with the last item.
+        //
+        if (TMF::numLoaded() != 0 || TMF::numLoadedBD() != 0) ++nfail;
+    }
+
+    ParallelDescriptor::ReduceIntSum(nfail);
+
+    amrex::Print() << (nfail == 0 ? "PASSED" : "FAILED") << " (" << nfail << " failures)\n";
+
+    amrex::Finalize();
+
+    return nfail != 0;
+}
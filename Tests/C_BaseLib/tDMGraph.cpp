@@ -0,0 +1,118 @@
+//
+// The GRAPH DistributionMapping strategy, makeGraph and makeRebalance.
+// The map must be the same on all processes, every box must go to a
+// valid process, every process must get work, and the loads must be
+// balanced.  Run it on several MPI processes.
+//
+
+#include <algorithm>
+#include <numeric>
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_DistributionMapping.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+//
+// The number of things wrong with dm for ba and the weights wgt.
+//
+static
+int
+checkMap (const DistributionMapping& dm, const BoxArray& ba, const std::vector<long>& wgt,
+          Real max_imbalance)
+{
+    const int nprocs = ParallelDescriptor::NProcs();
+    int nfail = 0;
+
+    if (dm.size() != ba.size()) return 1;
+
+    Vector<int> pmap = dm.ProcessorMap();
+    Vector<int> pmap0 = pmap;
+    ParallelDescriptor::Bcast(pmap0.dataPtr(), pmap0.size(), ParallelDescriptor::IOProcessorNumber());
+    if (pmap != pmap0) ++nfail;
+
+    std::vector<long> load(nprocs, 0);
+    for (int i = 0, N = ba.size(); i < N; ++i)
+    {
+        const int p = pmap[i];
+        if (p < 0 || p >= nprocs) {
+            ++nfail;
+        } else {
+            load[p] += wgt[i];
+        }
+    }
+
+    if (*std::min_element(load.begin(), load.end()) == 0) ++nfail;
+
+    const Real avg = static_cast<Real>(std::accumulate(load.begin(), load.end(), 0L))/nprocs;
+    if (*std::max_element(load.begin(), load.end()) > (1.0+max_imbalance)*avg) ++nfail;
+
+    return nfail;
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    int nfail = 0;
+
+    const Box domain(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(127,127,63)));
+    BoxArray ba(domain);
+    ba.maxSize(16);
+
+    //
+    // By volume.
+    //
+    {
+        DistributionMapping::strategy(DistributionMapping::GRAPH);
+        DistributionMapping dm(ba);
+        DistributionMapping::strategy(DistributionMapping::SFC);
+
+        std::vector<long> wgt(ba.size());
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            wgt[i] = ba[i].numPts();
+        }
+        nfail += checkMap(dm, ba, wgt, 0.25);
+    }
+
+    //
+    // By a weight that is heavier on one side of the domain.
+    //
+    {
+        DistributionMapping dm0(ba);
+        MultiFab weight(ba, dm0, 1, 0);
+        std::vector<long> wgt(ba.size());
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            wgt[i] = (ba[i].smallEnd(0) < 64) ? 1 : 4;
+        }
+        for (MFIter mfi(weight); mfi.isValid(); ++mfi) {
+            weight[mfi].setVal(static_cast<Real>(wgt[mfi.index()]));
+        }
+
+        DistributionMapping dm = DistributionMapping::makeGraph(weight, ba);
+        nfail += checkMap(dm, ba, wgt, 0.25);
+
+        //
+        // Rebalancing the volume map for the same weight, and for no
+        // weight at all, which must leave the map alone.
+        //
+        DistributionMapping rdm = DistributionMapping::makeRebalance(dm0, weight, 0.1);
+        nfail += checkMap(rdm, ba, wgt, 0.25);
+
+        weight.setVal(0.0);
+        DistributionMapping zdm = DistributionMapping::makeRebalance(dm0, weight, 0.1);
+        if (zdm != dm0) ++nfail;
+    }
+
+    ParallelDescriptor::ReduceIntSum(nfail);
+
+    amrex::Print() << (nfail == 0 ? "PASSED" : "FAILED") << " (" << nfail << " failures)\n";
+
+    amrex::Finalize();
+
+    return nfail != 0;
+}
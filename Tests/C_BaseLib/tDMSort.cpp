@@ -0,0 +1,74 @@
+//
+// SFC and KNAPSACK maps with the boxes sorted in parallel must be the
+// same as with the serial sort.  Many boxes have the same small end, and
+// so the same place on the curve, and many have the same weight, so the
+// ties must be broken the same way too.  Run it on several MPI processes.
+//
+
+#include <limits>
+
+#include <AMReX.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_BoxList.H>
+#include <AMReX_DistributionMapping.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    const int nprocs = ParallelDescriptor::NProcs();
+
+    //
+    // Boxes at pseudo-random places, every third one a copy of the one
+    // before it.
+    //
+    BoxList bl;
+    std::vector<long> wgts;
+    unsigned long seed = 12345;
+    Box bx;
+    for (int i = 0; i < 6000; ++i)
+    {
+        if (i % 3 != 2) {
+            IntVect lo;
+            for (int d = 0; d < BL_SPACEDIM; ++d) {
+                seed = seed*6364136223846793005UL + 1442695040888963407UL;
+                lo[d] = (seed >> 33) % 256;
+            }
+            bx = Box(lo, lo + IntVect(AMREX_D_DECL(7,7,7)));
+        }
+        bl.push_back(bx);
+        wgts.push_back(1 + i % 4);
+    }
+    const BoxArray ba(bl);
+
+    const int threshold = DistributionMapping::ParallelSort_Threshold();
+
+    DistributionMapping::ParallelSort_Threshold(std::numeric_limits<int>::max());
+    DistributionMapping sfc, knap;
+    sfc.SFCProcessorMap(ba, wgts, nprocs);
+    knap.KnapSackProcessorMap(wgts, nprocs);
+
+    DistributionMapping::ParallelSort_Threshold(1);
+    DistributionMapping psfc, pknap;
+    psfc.SFCProcessorMap(ba, wgts, nprocs);
+    pknap.KnapSackProcessorMap(wgts, nprocs);
+
+    DistributionMapping::ParallelSort_Threshold(threshold);
+
+    int nfail = 0;
+    if (sfc.ProcessorMap()  != psfc.ProcessorMap())  ++nfail;
+    if (knap.ProcessorMap() != pknap.ProcessorMap()) ++nfail;
+
+    ParallelDescriptor::ReduceIntSum(nfail);
+
+    amrex::Print() << (nfail == 0 ? "PASSED" : "FAILED") << " (" << nfail << " failures)\n";
+
+    amrex::Finalize();
+
+    return nfail != 0;
+}
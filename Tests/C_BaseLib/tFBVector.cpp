@@ -0,0 +1,115 @@
+//
+// FillBoundary of several MultiFabs with different numbers of components
+// together must fill the same ghost cells, with the same values, as
+// filling them one at a time, including across periodic boundaries and
+// when one of them still has a FillBoundary_nowait in flight.  Run it on
+// several MPI processes.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+static
+Real
+fval (const IntVect& iv, int n, int k)
+{
+    Real r = 10*k + n + 1;
+    for (int d = 0; d < BL_SPACEDIM; ++d) {
+        r = 100.0*r + iv[d];
+    }
+    return r;
+}
+
+//
+// The valid cells of mf get fval, the ghost cells -1.
+//
+static
+void
+init (MultiFab& mf, int k)
+{
+    mf.setVal(-1.0);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        FArrayBox& fab = mf[mfi];
+        const Box& bx = mfi.validbox();
+        for (int n = 0; n < mf.nComp(); ++n) {
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                fab(iv,n) = fval(iv,n,k);
+            }
+        }
+    }
+}
+
+//
+// The number of values, ghost cells included, where a and b differ.
+//
+static
+long
+ndiff (const MultiFab& a, const MultiFab& b)
+{
+    long nbad = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi)
+    {
+        const FArrayBox& fa = a[mfi];
+        const FArrayBox& fb = b[mfi];
+        const Box& bx = fa.box();
+        for (int n = 0; n < a.nComp(); ++n) {
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                if (fa(iv,n) != fb(iv,n)) ++nbad;
+            }
+        }
+    }
+    return nbad;
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    const Box domain(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(31,31,31)));
+    BoxArray ba(domain);
+    ba.maxSize(8);
+    DistributionMapping dm(ba);
+
+    const Periodicity period(IntVect(AMREX_D_DECL(32,32,0)));
+    const int ncomp[] = {2, 1, 3};
+    const int nmf = 3;
+
+    long nbad = 0;
+
+    for (int pending = 0; pending < 2; ++pending)
+    {
+        Vector<std::unique_ptr<MultiFab> > fused(nmf), single(nmf);
+        for (int k = 0; k < nmf; ++k)
+        {
+            fused[k].reset(new MultiFab(ba, dm, ncomp[k], 2));
+            single[k].reset(new MultiFab(ba, dm, ncomp[k], 2));
+            init(*fused[k], k);
+            init(*single[k], k);
+            single[k]->FillBoundary(period);
+        }
+
+        if (pending) {
+            fused[1]->FillBoundary_nowait(period);
+        }
+
+        amrex::FillBoundary(GetVecOfPtrs(fused), period);
+
+        for (int k = 0; k < nmf; ++k) {
+            nbad += ndiff(*fused[k], *single[k]);
+        }
+    }
+
+    ParallelDescriptor::ReduceLongSum(nbad);
+
+    amrex::Print() << (nbad == 0 ? "PASSED" : "FAILED") << " (" << nbad << " bad values)\n";
+
+    amrex::Finalize();
+
+    return nbad != 0;
+}
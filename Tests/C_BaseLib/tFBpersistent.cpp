@@ -0,0 +1,131 @@
+//
+// Two FillBoundary_nowait()s in flight at once on MultiFabs with the same
+// BoxArray and DistributionMapping, with fabarray.use_persistent_comm=1.
+// Both share one FB cache entry and so one persistent plan; the second
+// fill must not restart the first one's requests or reuse its buffers.
+// Run it on several MPI processes.  With fabarray.use_neighbor_collectives=1
+// on the command line it tests the neighborhood collective plans instead.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+static
+Real
+fval (const IntVect& iv, int n, Real sign)
+{
+    Real r = n + 1;
+    for (int d = 0; d < BL_SPACEDIM; ++d) {
+        r = 100.0*r + iv[d];
+    }
+    return sign*r;
+}
+
+static
+void
+setValid (MultiFab& mf, Real sign)
+{
+    mf.setVal(-1.e30);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        FArrayBox& fab = mf[mfi];
+        for (int n = 0; n < mf.nComp(); ++n) {
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                fab(iv,n) = fval(iv,n,sign);
+            }
+        }
+    }
+}
+
+//
+// The number of ghost cells inside the domain with the wrong value.
+//
+static
+long
+checkGhost (const MultiFab& mf, const Box& domain, Real sign)
+{
+    long nbad = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const Box bx = mfi.fabbox() & domain;
+        const FArrayBox& fab = mf[mfi];
+        for (int n = 0; n < mf.nComp(); ++n) {
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                if (fab(iv,n) != fval(iv,n,sign)) ++nbad;
+            }
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(nbad);
+    return nbad;
+}
+
+int
+main (int argc, char* argv[])
+{
+    //
+    // Turn on persistent communication whatever the inputs say.
+    //
+    Vector<char*> args(argv, argv+argc);
+    char persistent[] = "fabarray.use_persistent_comm=1";
+    args.push_back(persistent);
+    args.push_back(0);
+    int    nargs = argc+1;
+    char** pargs = args.dataPtr();
+
+    amrex::Initialize(nargs,pargs);
+
+    const Box domain(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(63,63,63)));
+    BoxArray ba(domain);
+    ba.maxSize(16);
+    DistributionMapping dm(ba);
+
+    const int ncomp = 2;
+    const int ngrow = 2;
+
+    MultiFab mf1(ba, dm, ncomp, ngrow);
+    MultiFab mf2(ba, dm, ncomp, ngrow);
+
+    long nbad = 0;
+
+    //
+    // The first pass builds the plan, the later ones reuse it.  Finish in
+    // both orders.
+    //
+    for (int iter = 0; iter < 4; ++iter)
+    {
+        setValid(mf1, 1.0);
+        setValid(mf2, -1.0);
+
+        mf1.FillBoundary_nowait();
+        mf2.FillBoundary_nowait();
+
+        if (iter % 2 == 0) {
+            mf2.FillBoundary_finish();
+            mf1.FillBoundary_finish();
+        } else {
+            mf1.FillBoundary_finish();
+            mf2.FillBoundary_finish();
+        }
+
+        nbad += checkGhost(mf1, domain, 1.0);
+        nbad += checkGhost(mf2, domain, -1.0);
+    }
+
+    //
+    // And a blocking one after them, which must find the plan free again.
+    //
+    setValid(mf1, 1.0);
+    mf1.FillBoundary();
+    nbad += checkGhost(mf1, domain, 1.0);
+
+    amrex::Print() << (nbad == 0 ? "PASSED" : "FAILED") << " (" << nbad << " bad ghost cells)\n";
+
+    amrex::Finalize();
+
+    return nbad != 0;
+}
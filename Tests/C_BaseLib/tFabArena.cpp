@@ -0,0 +1,63 @@
+//
+// fab.arena picks The_Arena() at amrex::Initialize(), before anything is
+// allocated from it.  Once The_Arena() has been used it must not be
+// replaced, even after every FAB is gone, since other memory from it may
+// still be live.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_BArena.H>
+#include <AMReX_TArena.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+int
+main (int argc, char* argv[])
+{
+    Vector<char*> args(argv, argv+argc);
+    char arena[] = "fab.arena=tarena";
+    args.push_back(arena);
+    args.push_back(0);
+    int    nargs = argc+1;
+    char** pargs = args.dataPtr();
+
+    amrex::Initialize(nargs,pargs);
+
+    int nfail = 0;
+
+    Arena* a = The_Arena();
+    if (dynamic_cast<TArena*>(a) == 0) ++nfail;
+
+    //
+    // Memory from The_Arena() that isn't FAB data.
+    //
+    void* p = a->alloc(1024);
+    {
+        const Box domain(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(31,31,31)));
+        BoxArray ba(domain);
+        ba.maxSize(16);
+        DistributionMapping dm(ba);
+        MultiFab mf(ba, dm, 1, 1);
+        mf.setVal(1.0);
+    }
+    if (TotalBytesAllocatedInFabs() != 0) ++nfail;
+
+    ParmParse pp("fab");
+    pp.add("arena", std::string("barena"));
+    InitializeFabArena();
+
+    if (The_Arena() != a || dynamic_cast<BArena*>(The_Arena()) != 0) ++nfail;
+
+    a->free(p);
+
+    ParallelDescriptor::ReduceIntSum(nfail);
+
+    amrex::Print() << (nfail == 0 ? "PASSED" : "FAILED") << " (" << nfail << " failures)\n";
+
+    amrex::Finalize();
+
+    return nfail != 0;
+}
@@ -0,0 +1,99 @@
+//
+// With fabarray.numa_first_touch=1 the data of a FabArray come from
+// The_Numa_Arena() and are first touched tile by tile.  They must start
+// with the same values as FABs from The_Arena(): fab.initval for
+// FArrayBoxes with fab.do_initval=1, and zero for other BaseFabs.
+// Build it with OpenMP and run it with more than one thread:
+//
+//   OMP_NUM_THREADS=4 ./tNumaInit
+//
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <cstdint>
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_NArena.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+//
+// The number of values in the FABs of fa, ghost cells included, that
+// aren't v, and of FABs that don't start on a page of their own.
+//
+template <class FAB>
+static
+long
+checkInit (const FabArray<FAB>& fa, typename FAB::value_type v)
+{
+    long nbad = 0;
+    for (MFIter mfi(fa); mfi.isValid(); ++mfi)
+    {
+        const FAB& fab = fa[mfi];
+        if (reinterpret_cast<std::uintptr_t>(fab.dataPtr()) % NArena::pageSize() != 0) ++nbad;
+        const Box& bx = fab.box();
+        for (int n = 0; n < fab.nComp(); ++n) {
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                if (fab(iv,n) != v) ++nbad;
+            }
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(nbad);
+    return nbad;
+}
+
+int
+main (int argc, char* argv[])
+{
+    Vector<char*> args(argv, argv+argc);
+    char first_touch[] = "fabarray.numa_first_touch=1";
+    char do_initval[]  = "fab.do_initval=1";
+    char initval[]     = "fab.initval=3.5";
+    char init_snan[]   = "fab.init_snan=0";
+    args.push_back(first_touch);
+    args.push_back(do_initval);
+    args.push_back(initval);
+    args.push_back(init_snan);
+    args.push_back(0);
+    int    nargs = argc+4;
+    char** pargs = args.dataPtr();
+
+    amrex::Initialize(nargs,pargs);
+
+#ifdef _OPENMP
+    const int nthreads = omp_get_max_threads();
+#else
+    const int nthreads = 1;
+#endif
+
+    long nbad = 0;
+
+    if (nthreads > 1)
+    {
+        const Box domain(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(63,63,63)));
+        BoxArray ba(domain);
+        ba.maxSize(32);
+        DistributionMapping dm(ba);
+
+        MultiFab mf(ba, dm, 3, 2);
+        nbad += checkInit(mf, 3.5);
+
+        FabArray<BaseFab<int> > ifa(ba, dm, 2, 1);
+        nbad += checkInit(ifa, 0);
+    }
+    else
+    {
+        amrex::Print() << "Only one thread, so numa_first_touch is not used\n";
+    }
+
+    amrex::Print() << (nbad == 0 ? "PASSED" : "FAILED") << " (" << nbad << " bad values)\n";
+
+    amrex::Finalize();
+
+    return nbad != 0;
+}
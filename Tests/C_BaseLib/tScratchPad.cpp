@@ -0,0 +1,135 @@
+//
+// Nested ScratchScopes push and pop the calling thread's ScratchPad.
+// Memory from an outer scope must survive the inner ones, an inner scope
+// must reuse the memory of the one before it, and once the outermost
+// scope is done the pad must hold what the pattern needs in one chunk,
+// so a second pass doesn't grow it.  With fab.scratch_chunk_bytes=4096
+// the pattern needs several chunks.  Run it with several OpenMP threads
+// too.
+//
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+
+#include <AMReX.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_ScratchPad.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+static
+bool
+aligned (const void* p)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % ScratchPad::Align == 0;
+}
+
+static
+bool
+filled (const char* p, std::size_t n, char v)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        if (p[i] != v) return false;
+    }
+    return true;
+}
+
+//
+// One pass of nested scopes.  Returns the number of things wrong.
+//
+static
+int
+pass (char tag)
+{
+    int nfail = 0;
+
+    ScratchScope outer;
+
+    char* a = outer.alloc<char>(1000);
+    std::memset(a, tag, 1000);
+    if (!aligned(a)) ++nfail;
+
+    char* first = 0;
+    for (int k = 0; k < 3; ++k)
+    {
+        ScratchScope inner;
+
+        char* b = inner.alloc<char>(3000);
+        std::memset(b, tag+1, 3000);
+        if (!aligned(b)) ++nfail;
+        //
+        // Each inner scope starts where the one before it did.
+        //
+        if (k == 0) first = b;
+        if (b != first) ++nfail;
+
+        {
+            ScratchScope innermost;
+            //
+            // More than a chunk, so the pad grows.
+            //
+            char* c = innermost.alloc<char>(10000);
+            std::memset(c, tag+2, 10000);
+
+            const Box bx(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(7,7,7)));
+            FArrayBox fab = innermost.fab<FArrayBox>(bx, 2);
+            fab.setVal(1.0);
+            if (!aligned(fab.dataPtr()) || fab.sum(0) != bx.numPts()) ++nfail;
+
+            if (!filled(c, 10000, tag+2)) ++nfail;
+        }
+
+        if (!filled(b, 3000, tag+1)) ++nfail;
+    }
+
+    if (!filled(a, 1000, tag)) ++nfail;
+
+    return nfail;
+}
+
+int
+main (int argc, char* argv[])
+{
+    Vector<char*> args(argv, argv+argc);
+    char chunk[] = "fab.scratch_chunk_bytes=4096";
+    args.push_back(chunk);
+    args.push_back(0);
+    int    nargs = argc+1;
+    char** pargs = args.dataPtr();
+
+    amrex::Initialize(nargs,pargs);
+
+    int nfail = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:nfail)
+#endif
+    {
+#ifdef _OPENMP
+        const char tag = 'a' + 3*omp_get_thread_num();
+#else
+        const char tag = 'a';
+#endif
+        ScratchPad* pad = ScratchPad::get();
+        if (pad == 0) ++nfail;
+
+        nfail += pass(tag);
+
+        const std::size_t cap = pad ? pad->capacity() : 0;
+
+        nfail += pass(tag);
+
+        if (pad && pad->capacity() != cap) ++nfail;
+    }
+
+    amrex::Print() << (nfail == 0 ? "PASSED" : "FAILED") << " (" << nfail << " failures)\n";
+
+    amrex::Finalize();
+
+    return nfail != 0;
+}
@@ -0,0 +1,178 @@
+//
+// TArena under random allocations and frees of 1 B to 300 KB, and a few
+// larger ones, from every OpenMP thread.  Every block is filled and must
+// still hold its fill when freed, the size classes must waste at most a
+// quarter of a block, and after everything is freed release() must give
+// all the memory back.  Also times the same pattern with BArena and a
+// locked CArena:
+//
+//   OMP_NUM_THREADS=4 ./tTArena
+//
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <cstring>
+#include <vector>
+
+#include <AMReX.H>
+#include <AMReX_BArena.H>
+#include <AMReX_CArena.H>
+#include <AMReX_TArena.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+//
+// CArena isn't thread safe, so its timing is with a lock around it.
+//
+class LockedCArena
+    : public Arena
+{
+public:
+    virtual void* alloc (std::size_t nbytes) override
+    {
+        void* p;
+#ifdef _OPENMP
+#pragma omp critical(lockedcarena)
+#endif
+        p = m_arena.alloc(nbytes);
+        return p;
+    }
+
+    virtual void free (void* vp) override
+    {
+#ifdef _OPENMP
+#pragma omp critical(lockedcarena)
+#endif
+        m_arena.free(vp);
+    }
+
+private:
+    CArena m_arena;
+};
+
+//
+// Each thread keeps up to nlive blocks and replaces a random one of them
+// niter times.  Returns the number of blocks that lost their fill.
+//
+static
+long
+churn (Arena& arena, int niter, int nlive, bool check)
+{
+    long nbad = 0;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:nbad)
+#endif
+    {
+#ifdef _OPENMP
+        unsigned long seed = 1234 + omp_get_thread_num();
+#else
+        unsigned long seed = 1234;
+#endif
+        std::vector<unsigned char*> blk(nlive, nullptr);
+        std::vector<std::size_t>    len(nlive, 0);
+
+        for (int it = 0; it < niter; ++it)
+        {
+            seed = seed*6364136223846793005UL + 1442695040888963407UL;
+            const int k = (seed >> 33) % nlive;
+            seed = seed*6364136223846793005UL + 1442695040888963407UL;
+            std::size_t n = 1 + (seed >> 33) % (300*1024);
+            if (it % 1000 == 999) n += TArena::MaxBlockSize;
+
+            if (blk[k])
+            {
+                if (check)
+                {
+                    const unsigned char v = static_cast<unsigned char>(len[k]);
+                    for (std::size_t i = 0; i < len[k]; ++i) {
+                        if (blk[k][i] != v) { ++nbad; break; }
+                    }
+                }
+                arena.free(blk[k]);
+            }
+
+            blk[k] = static_cast<unsigned char*>(arena.alloc(n));
+            len[k] = n;
+            if (check) {
+                std::memset(blk[k], static_cast<unsigned char>(n), n);
+            } else {
+                blk[k][0] = blk[k][n-1] = 0;
+            }
+        }
+
+        for (int k = 0; k < nlive; ++k) {
+            arena.free(blk[k]);
+        }
+    }
+    return nbad;
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    int nfail = 0;
+
+    //
+    // Consecutive size classes are at most 25% apart.
+    //
+    for (int c = 0; c+1 < TArena::NClasses; ++c)
+    {
+        if (TArena::classSize(c+1) <= TArena::classSize(c) ||
+            4*TArena::classSize(c+1) > 5*TArena::classSize(c))
+        {
+            ++nfail;
+        }
+    }
+    if (TArena::classSize(TArena::NClasses-1) != std::size_t(TArena::MaxBlockSize)) ++nfail;
+
+    long nbad = 0;
+    {
+        TArena arena;
+        nbad += churn(arena, 20000, 64, true);
+        if (arena.heap_space_used() == 0) ++nfail;
+        arena.release();
+        if (arena.heap_space_used() != 0) ++nfail;
+        //
+        // And it can be used again afterwards.
+        //
+        nbad += churn(arena, 2000, 16, true);
+        arena.release();
+        if (arena.heap_space_used() != 0) ++nfail;
+    }
+
+    //
+    // The timings.
+    //
+    {
+        const int niter = 200000;
+        const int nlive = 64;
+
+        TArena tarena;
+        BArena barena;
+        LockedCArena carena;
+
+        double t0 = ParallelDescriptor::second();
+        churn(tarena, niter, nlive, false);
+        double t1 = ParallelDescriptor::second();
+        churn(barena, niter, nlive, false);
+        double t2 = ParallelDescriptor::second();
+        churn(carena, niter, nlive, false);
+        double t3 = ParallelDescriptor::second();
+
+        amrex::Print() << "TArena " << t1-t0 << " s, BArena " << t2-t1
+                       << " s, CArena " << t3-t2 << " s\n";
+    }
+
+    amrex::Print() << (nbad == 0 && nfail == 0 ? "PASSED" : "FAILED")
+                   << " (" << nbad << " bad blocks, " << nfail << " failures)\n";
+
+    amrex::Finalize();
+
+    return nbad != 0 || nfail != 0;
+}
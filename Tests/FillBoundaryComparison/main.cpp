@@ -124,48 +124,102 @@ main (int argc, char* argv[])
     }
 
     int nrounds = 1000;
+    int nwarmup = 10;
     {
 	ParmParse pp;
 	pp.query("nrounds", nrounds);
+	pp.query("nwarmup", nwarmup);
     }
 
     Real err = 0.0;
 
-    ParallelDescriptor::Barrier();
-    Real wt0 = ParallelDescriptor::second();
-
-    for (int iround = 0; iround < nrounds; ++iround) {
-	for (int c=0; c<2; ++c) {
-	    for (int lev = 0; lev < nlevels; ++lev) {
-		mfs[lev]->FillBoundary_nowait(true);
-		mfs[lev]->FillBoundary_finish();
-	    }
-	    for (int lev = nlevels-1; lev >= 0; --lev) {
-		mfs[lev]->FillBoundary_nowait(true);
-		mfs[lev]->FillBoundary_finish();
-	    }
-	}
-	Real e = double(iround+ParallelDescriptor::MyProc());
-	ParallelDescriptor::ReduceRealMax(e);
-	err += e;
-    }
-	    
-    ParallelDescriptor::Barrier();
-    Real wt1 = ParallelDescriptor::second();
+    //
+    // The first rounds build the FB cache entries and their persistent or
+    // neighborhood collective plans, so each backend is warmed up by
+    // nwarmup untimed rounds before it is timed.
+    //
+    auto fill_boundary_time = [&] () -> Real
+    {
+        auto fill_boundary_rounds = [&] (int nr)
+        {
+            err = 0.0;
+            for (int iround = 0; iround < nr; ++iround) {
+                for (int c=0; c<2; ++c) {
+                    for (int lev = 0; lev < nlevels; ++lev) {
+                        mfs[lev]->FillBoundary_nowait(true);
+                        mfs[lev]->FillBoundary_finish();
+                    }
+                    for (int lev = nlevels-1; lev >= 0; --lev) {
+                        mfs[lev]->FillBoundary_nowait(true);
+                        mfs[lev]->FillBoundary_finish();
+                    }
+                }
+                Real e = double(iround+ParallelDescriptor::MyProc());
+                ParallelDescriptor::ReduceRealMax(e);
+                err += e;
+            }
+        };
+
+        fill_boundary_rounds(nwarmup);
+
+        ParallelDescriptor::Barrier();
+        Real wt0 = ParallelDescriptor::second();
+
+        fill_boundary_rounds(nrounds);
+
+        ParallelDescriptor::Barrier();
+        Real wt1 = ParallelDescriptor::second();
+        return wt1-wt0;
+    };
 
-    if (ParallelDescriptor::IOProcessor()) {
+    auto backend_name = [] () -> std::string
+    {
 #ifdef BL_USE_UPCXX
-        std::cout << "Using UPCXX" << std::endl;
+        return "UPCXX";
 #else
 	if (ParallelDescriptor::MPIOneSided()) {
-	    std::cout << "Using MPI Onesided" << std::endl;
+	    return "MPI Onesided";
+	} else if (FabArrayBase::use_neighbor_collectives) {
+	    return "MPI Neighbor Collectives";
+	} else if (FabArrayBase::use_persistent_comm) {
+	    return "MPI Persistent";
 	} else {
-	    std::cout << "Using MPI" << std::endl;
+	    return "MPI";
 	}
 #endif
+    };
+
+    Real fb_time = fill_boundary_time();
+
+    if (ParallelDescriptor::IOProcessor()) {
+        std::cout << "Using " << backend_name() << std::endl;
 	std::cout << "----------------------------------------------" << std::endl;
-	std::cout << "Fill Boundary Time: " << wt1-wt0 << std::endl;
+	std::cout << "Fill Boundary Time: " << fb_time << std::endl;
 	std::cout << "----------------------------------------------" << std::endl;
+    }
+
+#if defined(BL_USE_MPI3) && !defined(BL_USE_UPCXX)
+    //
+    // A/B comparison between point-to-point and neighborhood collectives.
+    //
+    if (!ParallelDescriptor::MPIOneSided())
+    {
+        FabArrayBase::use_neighbor_collectives = !FabArrayBase::use_neighbor_collectives;
+
+        fb_time = fill_boundary_time();
+
+        if (ParallelDescriptor::IOProcessor()) {
+            std::cout << "Using " << backend_name() << std::endl;
+            std::cout << "----------------------------------------------" << std::endl;
+            std::cout << "Fill Boundary Time: " << fb_time << std::endl;
+            std::cout << "----------------------------------------------" << std::endl;
+        }
+
+        FabArrayBase::use_neighbor_collectives = !FabArrayBase::use_neighbor_collectives;
+    }
+#endif
+
+    if (ParallelDescriptor::IOProcessor()) {
 	std::cout << "ignore this line " << err << std::endl;
     }
 